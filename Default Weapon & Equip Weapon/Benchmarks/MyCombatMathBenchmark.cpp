@@ -0,0 +1,89 @@
+#include "MyCombatMath.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+//Per call cost of the per frame camera and anim math, over a spread of inputs so branches aren't all predicted the same way
+namespace
+{
+	struct FBenchVector
+	{
+		float X = 0.f;
+		float Y = 0.f;
+		float Z = 0.f;
+	};
+
+	struct FBenchRotator
+	{
+		float Pitch = 0.f;
+		float Yaw = 0.f;
+		float Roll = 0.f;
+	};
+
+	constexpr int NumInputs = 1024;
+
+	std::vector<float> MakeInputs(float Min, float Max, unsigned Seed)
+	{
+		std::vector<float> Inputs(NumInputs);
+		unsigned State = Seed;
+		for (float& Input : Inputs)
+		{
+			State = State * 1664525u + 1013904223u;
+			Input = Min + (Max - Min) * static_cast<float>(State >> 8) / static_cast<float>(1u << 24);
+		}
+		return Inputs;
+	}
+}
+
+static void BM_InterpTo(benchmark::State& State)
+{
+	const std::vector<float> Current = MakeInputs(60.f, 110.f, 1);
+	const std::vector<float> Target = MakeInputs(60.f, 110.f, 2);
+	int Index = 0;
+	for (auto _ : State)
+	{
+		benchmark::DoNotOptimize(MyCombatMath::InterpTo(Current[Index], Target[Index], 1.f / 60.f, 20.f));
+		Index = (Index + 1) & (NumInputs - 1);
+	}
+}
+BENCHMARK(BM_InterpTo);
+
+static void BM_VectorInterpTo(benchmark::State& State)
+{
+	const std::vector<float> Values = MakeInputs(-200.f, 200.f, 3);
+	int Index = 0;
+	for (auto _ : State)
+	{
+		const FBenchVector Current{ Values[Index], Values[(Index + 1) & (NumInputs - 1)], Values[(Index + 2) & (NumInputs - 1)] };
+		const FBenchVector Target{ Values[(Index + 3) & (NumInputs - 1)], 0.f, 40.f };
+		benchmark::DoNotOptimize(MyCombatMath::VectorInterpTo(Current, Target, 1.f / 60.f, 20.f));
+		Index = (Index + 1) & (NumInputs - 1);
+	}
+}
+BENCHMARK(BM_VectorInterpTo);
+
+static void BM_RotatorInterpTo(benchmark::State& State)
+{
+	const std::vector<float> Angles = MakeInputs(-540.f, 540.f, 4);
+	int Index = 0;
+	for (auto _ : State)
+	{
+		const FBenchRotator Current{ Angles[Index], Angles[(Index + 1) & (NumInputs - 1)], 0.f };
+		const FBenchRotator Target{ Angles[(Index + 2) & (NumInputs - 1)], Angles[(Index + 3) & (NumInputs - 1)], 0.f };
+		benchmark::DoNotOptimize(MyCombatMath::RotatorInterpTo(Current, Target, 1.f / 60.f, 8.f));
+		Index = (Index + 1) & (NumInputs - 1);
+	}
+}
+BENCHMARK(BM_RotatorInterpTo);
+
+static void BM_StrafeYaw(benchmark::State& State)
+{
+	const std::vector<float> Velocities = MakeInputs(-600.f, 600.f, 5);
+	const std::vector<float> AimYaws = MakeInputs(-180.f, 180.f, 6);
+	int Index = 0;
+	for (auto _ : State)
+	{
+		benchmark::DoNotOptimize(MyCombatMath::StrafeYaw(Velocities[Index], Velocities[(Index + 7) & (NumInputs - 1)], AimYaws[Index]));
+		Index = (Index + 1) & (NumInputs - 1);
+	}
+}
+BENCHMARK(BM_StrafeYaw);
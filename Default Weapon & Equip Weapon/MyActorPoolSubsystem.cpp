@@ -0,0 +1,229 @@
+#include "MyActorPoolSubsystem.h"
+#include "MyWeapon.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "UObject/UObjectGlobals.h"
+#include "MyCombatStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Actor Pool Acquire"), STAT_ShooterPoolAcquire, STATGROUP_ShooterCombat);
+DECLARE_CYCLE_STAT(TEXT("Actor Pool Tick"), STAT_ShooterPoolTick, STATGROUP_ShooterCombat);
+
+bool UMyActorPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UMyActorPoolSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMyActorPoolSubsystem, STATGROUP_Tickables);
+}
+
+void UMyActorPoolSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	for (const FMyActorPoolPrewarm& Entry : PrewarmClasses)
+	{
+		if (UClass* Class = Entry.Class.LoadSynchronous())
+		{
+			Prewarm(Class, Entry.Count);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Actor pool: can't load %s to prewarm"), *Entry.Class.ToString());
+		}
+	}
+}
+
+void UMyActorPoolSubsystem::Deinitialize()
+{
+	for (const TPair<UClass*, FMyActorPoolBucket>& Entry : Buckets)
+	{
+		const FMyActorPoolBucket& Bucket = Entry.Value;
+		if (Bucket.Hits + Bucket.Misses > 0)
+		{
+			UE_LOG(LogTemp, Log, TEXT("Actor pool: %s %lld acquires, %.1f%% from the pool, %d actors spawned"),
+				*GetNameSafe(Entry.Key), Bucket.Hits + Bucket.Misses, 100.0 * Bucket.Hits / (Bucket.Hits + Bucket.Misses), Bucket.NumSpawned);
+		}
+	}
+	Super::Deinitialize();
+}
+
+void UMyActorPoolSubsystem::Prewarm(TSubclassOf<AActor> Class, int32 Count)
+{
+	if (!Class)
+	{
+		return;
+	}
+	FMyActorPoolBucket& Bucket = Buckets.FindOrAdd(Class);
+	Bucket.FreeActors.Reserve(Bucket.FreeActors.Num() + Count);
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		if (AActor* Actor = SpawnForPool(Class, FTransform::Identity))
+		{
+			ReleasedActors.Add(Actor);
+			ReturnToPool(Actor);
+		}
+	}
+}
+
+AActor* UMyActorPoolSubsystem::SpawnForPool(UClass* Class, const FTransform& Transform)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AActor* Actor = GetWorld()->SpawnActor<AActor>(Class, Transform, SpawnParams);
+	if (Actor)
+	{
+		Buckets.FindOrAdd(Class).NumSpawned++;
+	}
+	return Actor;
+}
+
+AActor* UMyActorPoolSubsystem::AcquireActor(TSubclassOf<AActor> Class, const FTransform& Transform)
+{
+	SHOOTER_COMBAT_SCOPE(STAT_ShooterPoolAcquire);
+	if (!Class)
+	{
+		return nullptr;
+	}
+
+	FMyActorPoolBucket& Bucket = Buckets.FindOrAdd(Class);
+	while (Bucket.FreeActors.Num() > 0)
+	{
+		AActor* Actor = Bucket.FreeActors.Pop(EAllowShrinking::No);
+		if (!IsValid(Actor))
+		{
+			continue; //Destroyed while waiting, by streaming or someone who didn't know it was pooled
+		}
+		ReleasedActors.Remove(Actor);
+		Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+		Actor->SetActorHiddenInGame(false);
+		Actor->SetActorEnableCollision(true);
+		Actor->SetActorTickEnabled(Actor->PrimaryActorTick.bStartWithTickEnabled);
+		if (IMyPooledActor* Pooled = Cast<IMyPooledActor>(Actor))
+		{
+			Pooled->OnAcquiredFromPool();
+		}
+		Bucket.Hits++;
+		Hits++;
+		MyCombatStats::AddPooledActorHit();
+		return Actor;
+	}
+
+	Bucket.Misses++;
+	Misses++;
+	MyCombatStats::AddPooledActorMiss();
+	return SpawnForPool(Class, Transform);
+}
+
+void UMyActorPoolSubsystem::ReleaseActor(AActor* Actor, float Delay)
+{
+	if (!IsValid(Actor) || ReleasedActors.Contains(Actor))
+	{
+		return;
+	}
+	ReleasedActors.Add(Actor);
+	FPendingRelease& Release = PendingReleases.AddDefaulted_GetRef();
+	Release.Actor = Actor;
+	Release.ReleaseSeconds = GetWorld()->GetTimeSeconds() + Delay;
+}
+
+void UMyActorPoolSubsystem::FlushPendingReleases()
+{
+	for (const FPendingRelease& Release : PendingReleases)
+	{
+		if (AActor* Actor = Release.Actor.Get())
+		{
+			ReturnToPool(Actor);
+		}
+	}
+	PendingReleases.Reset();
+}
+
+void UMyActorPoolSubsystem::Tick(float DeltaTime)
+{
+	SHOOTER_COMBAT_SCOPE(STAT_ShooterPoolTick);
+	Super::Tick(DeltaTime);
+
+	const double NowSeconds = GetWorld()->GetTimeSeconds();
+	for (int32 Index = PendingReleases.Num() - 1; Index >= 0; Index--)
+	{
+		const FPendingRelease& Release = PendingReleases[Index];
+		if (Release.ReleaseSeconds > NowSeconds)
+		{
+			continue;
+		}
+		if (AActor* Actor = Release.Actor.Get())
+		{
+			ReturnToPool(Actor);
+		}
+		PendingReleases.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	}
+}
+
+void UMyActorPoolSubsystem::ReturnToPool(AActor* Actor)
+{
+	if (IMyPooledActor* Pooled = Cast<IMyPooledActor>(Actor))
+	{
+		Pooled->OnReturnedToPool();
+	}
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+	Actor->SetActorTickEnabled(false);
+	Buckets.FindOrAdd(Actor->GetClass()).FreeActors.Add(Actor);
+}
+
+//Shooter.Pool.Benchmark [Count] [WeaponClassPath]
+//Cycles Count weapon spawn/despawns with SpawnActor/Destroy, then through the pool, and times a full GC after each.
+static FAutoConsoleCommandWithWorldAndArgs GPoolBenchmarkCommand(
+	TEXT("Shooter.Pool.Benchmark"),
+	TEXT("Shooter.Pool.Benchmark [Count] [WeaponClassPath]: compare spawn/destroy against the actor pool, GC time included"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UMyActorPoolSubsystem* Pool = World ? World->GetSubsystem<UMyActorPoolSubsystem>() : nullptr;
+		if (!Pool)
+		{
+			return;
+		}
+		const int32 Count = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10'000;
+		UClass* WeaponClass = Args.Num() > 1 ? LoadClass<AMyWeapon>(nullptr, *Args[1]) : AMyWeapon::StaticClass();
+		if (!WeaponClass)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Actor pool: can't load weapon class %s"), *Args[1]);
+			return;
+		}
+
+		const FTransform Transform(FVector(0.f, 0.f, -10'000.f));
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true); //Start both runs from a clean heap
+
+		double StartSeconds = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Count; Index++)
+		{
+			if (AActor* Weapon = World->SpawnActor<AActor>(WeaponClass, Transform, SpawnParams))
+			{
+				Weapon->Destroy();
+			}
+		}
+		const double SpawnMs = (FPlatformTime::Seconds() - StartSeconds) * 1000.0;
+		StartSeconds = FPlatformTime::Seconds();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+		const double SpawnGCMs = (FPlatformTime::Seconds() - StartSeconds) * 1000.0;
+
+		const int64 HitsBefore = Pool->GetHits();
+		StartSeconds = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Count; Index++)
+		{
+			Pool->ReleaseActor(Pool->AcquireActor(WeaponClass, Transform));
+			Pool->FlushPendingReleases();
+		}
+		const double PoolMs = (FPlatformTime::Seconds() - StartSeconds) * 1000.0;
+		StartSeconds = FPlatformTime::Seconds();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+		const double PoolGCMs = (FPlatformTime::Seconds() - StartSeconds) * 1000.0;
+
+		UE_LOG(LogTemp, Log, TEXT("Actor pool benchmark, %d cycles of %s: spawn/destroy %.2f ms + GC %.2f ms, pooled %.2f ms + GC %.2f ms (%lld pool hits)"),
+			Count, *WeaponClass->GetName(), SpawnMs, SpawnGCMs, PoolMs, PoolGCMs, Pool->GetHits() - HitsBefore);
+	}));
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/Interface.h"
+#include "UObject/ObjectKey.h"
+#include "MyActorPoolSubsystem.generated.h"
+
+UINTERFACE(MinimalAPI)
+class UMyPooledActor : public UInterface
+{
+	GENERATED_BODY()
+};
+
+//Reset hooks for actors handed out by UMyActorPoolSubsystem. The pool itself toggles visibility, actor collision and tick,
+//the hooks put back whatever else a freshly spawned actor would have.
+class UE5POINT5_SHOOTER_API IMyPooledActor
+{
+	GENERATED_BODY()
+
+public:
+	//Already moved to its new transform, visible and colliding
+	virtual void OnAcquiredFromPool() {}
+	//Called before the pool hides it, so it can still detach and end its overlaps
+	virtual void OnReturnedToPool() {}
+};
+
+//Actors of one class spawned at level load, before anyone asks for them
+USTRUCT()
+struct FMyActorPoolPrewarm
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Config)
+	TSoftClassPtr<AActor> Class;
+	UPROPERTY(Config)
+	int32 Count = 0;
+};
+
+USTRUCT()
+struct FMyActorPoolBucket
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AActor*> FreeActors;
+
+	int32 NumSpawned = 0;
+	int64 Hits = 0; //Acquires served from FreeActors
+	int64 Misses = 0; //Acquires that had to spawn
+};
+
+//Reuses actors instead of spawning and destroying them, so weapons that are dropped, picked up and respawned don't feed GC.
+//Actors waiting in the pool stay in the level, hidden with collision and tick off. Any actor class can be pooled,
+//implementing IMyPooledActor lets it reset its own state. Releases are deferred to the pool's tick (optionally by a delay),
+//so an actor can be released from inside its own overlap or damage callbacks.
+//Prewarm in DefaultGame.ini:
+//  [/Script/UE5Point5_Shooter.MyActorPoolSubsystem]
+//  +PrewarmClasses=(Class="/Game/Blueprints/BP_Weapon.BP_Weapon_C",Count=32)
+UCLASS(config = Game)
+class UE5POINT5_SHOOTER_API UMyActorPoolSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void Prewarm(TSubclassOf<AActor> Class, int32 Count);
+	AActor* AcquireActor(TSubclassOf<AActor> Class, const FTransform& Transform);
+	template<typename T>
+	T* Acquire(TSubclassOf<T> Class, const FTransform& Transform) { return Cast<T>(AcquireActor(Class.Get(), Transform)); }
+	//Returns the actor to the pool on the next pool tick at least Delay seconds from now. The caller must not touch it afterwards.
+	void ReleaseActor(AActor* Actor, float Delay = 0.f);
+	//Returns every pending release now, delay or not
+	void FlushPendingReleases();
+
+	FORCEINLINE int64 GetHits() const { return Hits; }
+	FORCEINLINE int64 GetMisses() const { return Misses; }
+
+private:
+	struct FPendingRelease
+	{
+		TWeakObjectPtr<AActor> Actor;
+		double ReleaseSeconds = 0.0;
+	};
+
+	AActor* SpawnForPool(UClass* Class, const FTransform& Transform);
+	void ReturnToPool(AActor* Actor);
+
+	UPROPERTY(Config)
+	TArray<FMyActorPoolPrewarm> PrewarmClasses;
+
+	UPROPERTY()
+	TMap<UClass*, FMyActorPoolBucket> Buckets;
+
+	TArray<FPendingRelease> PendingReleases;
+	TSet<TObjectKey<AActor>> ReleasedActors; //Pending or free, guards against releasing the same actor twice
+
+	int64 Hits = 0;
+	int64 Misses = 0;
+};
@@ -1,34 +1,28 @@
 #include "MyAnimInstance.h"
 #include "MyCharacter.h"
-#include "GameFramework/CharacterMovementComponent.h"
-#include "Kismet/KismetMathLibrary.h"
+#include "MyCombatStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Update Animation Properties"), STAT_ShooterUpdateAnimation, STATGROUP_ShooterCombat);
 
 
 void UMyAnimInstance::UpdateAnimationProperties(float DeltaTime)
 {
+	SHOOTER_COMBAT_CSV_SCOPE(STAT_ShooterUpdateAnimation, AnimUpdate);
 	if (Drongo == nullptr)
 		Drongo = Cast<AMyCharacter>(TryGetPawnOwner());
 	
 	if(Drongo)
 	{
-		FVector Velocity = Drongo->GetVelocity();
-		Velocity.Z = 0.f;
-		Speed = Velocity.Size(); //Stores Character's (Drongo) Speed
-	
-		if (Drongo->GetCharacterMovement()->GetCurrentAcceleration().Size() > 0.f) 
-			bIsAcclerating = true;
-		else
-			bIsAcclerating = false;
-		
-		FRotator PlayerAimRotation = Drongo->GetBaseAimRotation();
-		FRotator PlayerMoveRotation = UKismetMathLibrary::MakeRotFromX(Drongo->GetVelocity());
-		//Calculating strafe value
-		StrafeValue = UKismetMathLibrary::NormalizedDeltaRotator(PlayerMoveRotation, PlayerAimRotation).Yaw;
-		if (Drongo->GetVelocity().Size() > 0.f)
+		//Gathered by the character right after it moved this frame, see AMyCharacter::GatherAnimInputs
+		const FMyAnimInputs& Inputs = Drongo->GetAnimInputs();
+		Speed = Inputs.Speed; //Stores Character's (Drongo) Speed
+		bIsAcclerating = Inputs.bIsAccelerating;
+		StrafeValue = Inputs.StrafeValue;
+		if (Inputs.bIsMoving)
 		{
 			LastStrafeValue = StrafeValue; //Stores last strafe value if Velocity of character is not zero.
 		}
-		bIsAiming = Drongo->ReturnIsAiming();
+		bIsAiming = Inputs.bIsAiming;
 	}
 }
 
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MyBallisticsSubsystem.generated.h"
+
+struct FMyBulletImpact
+{
+	FHitResult Hit;
+	FVector Velocity = FVector::ZeroVector;
+	TWeakObjectPtr<AActor> Instigator;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnMyBulletImpact, const FMyBulletImpact&);
+
+//Bullets with drop and travel time, for long range weapons.
+//A bullet is only its launch parameters and age; its position is evaluated in closed form (p0 + v0*t + g*t^2/2), so nothing is integrated
+//and a bullet lands on the same arc at any frame rate. Every frame the segment each bullet covered is traced in one batch.
+UCLASS()
+class UE5POINT5_SHOOTER_API UMyBallisticsSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	void LaunchBullet(const FVector& Location, const FVector& Velocity, AActor* Instigator, float Lifetime, float GravityScale = 1.f);
+	FORCEINLINE int32 GetNumBullets() const { return LaunchX.Num(); }
+
+	FOnMyBulletImpact OnBulletImpact;
+
+private:
+	void EvaluateSegments(float DeltaTime);
+	void RemoveBullet(int32 Index);
+
+	//One entry per live bullet, always the same length. Removal swaps with the last entry.
+	TArray<float> LaunchX;
+	TArray<float> LaunchY;
+	TArray<float> LaunchZ;
+	TArray<float> VelocityX;
+	TArray<float> VelocityY;
+	TArray<float> VelocityZ;
+	TArray<float> HalfGravityZ; //g/2, so the drop term is one multiply
+	TArray<float> Age;
+	TArray<float> Lifetime;
+	TArray<TWeakObjectPtr<AActor>> Instigators;
+
+	//Per frame scratch, reused so a steady bullet count doesn't allocate
+	TArray<FVector> SegmentStarts;
+	TArray<FVector> SegmentEnds;
+	TArray<FHitResult> SegmentHits;
+	TArray<const AActor*> SegmentIgnoredActors;
+
+	//Tick accounting, logged in Deinitialize
+	uint64 TickCycles;
+	int32 BusyTicks;
+	int64 BulletTicks;
+};
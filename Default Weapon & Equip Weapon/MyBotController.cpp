@@ -0,0 +1,201 @@
+#include "MyBotController.h"
+#include "MyCharacter.h"
+#include "MyWeapon.h"
+#include "MyCombatReplaySubsystem.h"
+#include "EngineUtils.h"
+
+AMyBotController::AMyBotController()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	bSetControlRotationFromPawnOrientation = false; //We steer the control rotation ourselves, pitch included
+
+	Bot = nullptr;
+	Target = nullptr;
+	WeaponGoal = nullptr;
+
+	FireInterval = 0.3f;
+	UltimateInterval = 20.f;
+	PickupInterval = 30.f;
+	WanderRadius = 2000.f;
+	EngageRange = 3000.f;
+	PickupSearchRadius = 1500.f;
+
+	HomeLocation = FVector::ZeroVector;
+	WanderGoal = FVector::ZeroVector;
+	TimeToNewWanderGoal = 0.f;
+	TimeToRetarget = 0.f;
+	TimeToNextShot = 0.f;
+	TimeToNextUltimate = 0.f;
+	TimeToNextPickup = 0.f;
+
+	Replay = nullptr;
+	ReplayIndex = INDEX_NONE;
+}
+
+void AMyBotController::SetRandomSeed(int32 Seed)
+{
+	Random.Initialize(Seed);
+}
+
+void AMyBotController::OnPossess(APawn* InPawn)
+{
+	Super::OnPossess(InPawn);
+
+	Bot = Cast<AMyCharacter>(InPawn);
+	if (Bot)
+	{
+		HomeLocation = Bot->GetActorLocation();
+		TimeToNextUltimate = Random.FRandRange(0.5f, 1.f) * UltimateInterval; //Stagger bots so they don't all fire at once
+		TimeToNextPickup = Random.FRandRange(0.f, 1.f) * PickupInterval;
+		PickNewWanderGoal();
+
+		Replay = GetWorld()->GetSubsystem<UMyCombatReplaySubsystem>();
+		ReplayIndex = Replay ? Replay->RegisterBot(Bot, this) : INDEX_NONE;
+		if (ReplayIndex == INDEX_NONE)
+		{
+			Replay = nullptr;
+		}
+		else
+		{
+			HomeLocation = Bot->GetActorLocation(); //Playback may have moved us to the recorded start
+		}
+	}
+}
+
+void AMyBotController::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Bot)
+	{
+		if (Replay)
+		{
+			//Recording stores what we decided, playback replaces the decision with the recorded one
+			LastInput = Replay->ProcessInput(ReplayIndex, Replay->IsPlayingBack() ? FMyBotInput() : Think(DeltaTime));
+		}
+		else
+		{
+			LastInput = Think(DeltaTime);
+		}
+		Bot->ApplyBotInput(LastInput, DeltaTime);
+	}
+}
+
+void AMyBotController::PickNewWanderGoal()
+{
+	const FVector2D Offset = FVector2D(Random.FRandRange(-1.f, 1.f), Random.FRandRange(-1.f, 1.f)) * WanderRadius;
+	WanderGoal = HomeLocation + FVector(Offset, 0.f);
+	TimeToNewWanderGoal = Random.FRandRange(3.f, 8.f);
+}
+
+AMyCharacter* AMyBotController::FindTarget() const
+{
+	AMyCharacter* ClosestCharacter = nullptr;
+	float ClosestDistanceSquared = FMath::Square(EngageRange);
+	for (TActorIterator<AMyCharacter> It(GetWorld()); It; ++It)
+	{
+		const float DistanceSquared = FVector::DistSquared(It->GetActorLocation(), Bot->GetActorLocation());
+		if (*It != Bot && DistanceSquared < ClosestDistanceSquared)
+		{
+			ClosestCharacter = *It;
+			ClosestDistanceSquared = DistanceSquared;
+		}
+	}
+	return ClosestCharacter;
+}
+
+AMyWeapon* AMyBotController::FindWeaponToPickup() const
+{
+	AMyWeapon* ClosestWeapon = nullptr;
+	float ClosestDistanceSquared = FMath::Square(PickupSearchRadius);
+	for (TActorIterator<AMyWeapon> It(GetWorld()); It; ++It)
+	{
+		const float DistanceSquared = FVector::DistSquared(It->GetActorLocation(), Bot->GetActorLocation());
+		if (It->GetStateOfItem() == EStateOfItem::ESOI_NotEquipped && DistanceSquared < ClosestDistanceSquared)
+		{
+			ClosestWeapon = *It;
+			ClosestDistanceSquared = DistanceSquared;
+		}
+	}
+	return ClosestWeapon;
+}
+
+FMyBotInput AMyBotController::Think(float DeltaTime)
+{
+	FMyBotInput Input;
+
+	TimeToNewWanderGoal -= DeltaTime;
+	TimeToRetarget -= DeltaTime;
+	TimeToNextShot -= DeltaTime;
+	TimeToNextUltimate -= DeltaTime;
+	TimeToNextPickup -= DeltaTime;
+
+	if (TimeToRetarget <= 0.f)
+	{
+		Target = FindTarget();
+		TimeToRetarget = 1.f;
+	}
+	if (TimeToNextPickup <= 0.f)
+	{
+		WeaponGoal = FindWeaponToPickup();
+		TimeToNextPickup = PickupInterval;
+	}
+	if (WeaponGoal && WeaponGoal->GetStateOfItem() != EStateOfItem::ESOI_NotEquipped)
+	{
+		WeaponGoal = nullptr; //Someone else got it first
+	}
+
+	//Movement, towards a weapon if we want one, otherwise wander around home
+	FVector MoveGoal = WanderGoal;
+	if (WeaponGoal)
+	{
+		MoveGoal = WeaponGoal->GetActorLocation();
+		if (FVector::DistSquared2D(MoveGoal, Bot->GetActorLocation()) < FMath::Square(150.f))
+		{
+			Input.bPickup = true;
+			WeaponGoal = nullptr;
+		}
+	}
+	else if (TimeToNewWanderGoal <= 0.f || FVector::DistSquared2D(WanderGoal, Bot->GetActorLocation()) < FMath::Square(100.f))
+	{
+		PickNewWanderGoal();
+	}
+
+	const FRotator ControlRotation = GetControlRotation();
+	const FRotator YawRotation(0.f, ControlRotation.Yaw, 0.f);
+	const FVector MoveDirection = (MoveGoal - Bot->GetActorLocation()).GetSafeNormal2D();
+	Input.MoveForward = FVector::DotProduct(MoveDirection, FRotationMatrix(YawRotation).GetUnitAxis(EAxis::X));
+	Input.MoveRight = FVector::DotProduct(MoveDirection, FRotationMatrix(YawRotation).GetUnitAxis(EAxis::Y));
+
+	//Aim at the target, or look where we are going
+	FRotator DesiredRotation = MoveDirection.Rotation();
+	if (Target)
+	{
+		FVector EyesLocation;
+		FRotator EyesRotation;
+		Bot->GetActorEyesViewPoint(EyesLocation, EyesRotation);
+		DesiredRotation = (Target->GetActorLocation() - EyesLocation).Rotation();
+	}
+	const FRotator DeltaRotation = (DesiredRotation - ControlRotation).GetNormalized();
+	const float MaxYawStep = FMath::Max(Bot->GetBaseTurnRate() * DeltaTime, KINDA_SMALL_NUMBER);
+	const float MaxPitchStep = FMath::Max(Bot->GetBaseLookUpRate() * DeltaTime, KINDA_SMALL_NUMBER);
+	Input.TurnRate = FMath::Clamp(DeltaRotation.Yaw / MaxYawStep, -1.f, 1.f);
+	Input.LookUpRate = FMath::Clamp(DeltaRotation.Pitch / MaxPitchStep, -1.f, 1.f);
+
+	//Combat
+	if (Target)
+	{
+		Input.bAim = true;
+		if (FMath::Abs(DeltaRotation.Yaw) < 10.f && TimeToNextShot <= 0.f)
+		{
+			Input.bFire = true;
+			TimeToNextShot = FireInterval * Random.FRandRange(0.8f, 1.2f);
+		}
+		if (TimeToNextUltimate <= 0.f)
+		{
+			Input.bUltimate = true;
+			TimeToNextUltimate = UltimateInterval;
+		}
+	}
+	return Input;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIController.h"
+#include "MyBotController.generated.h"
+
+//One frame of bot input, in the same units as the player's axis and action bindings
+struct FMyBotInput
+{
+	float MoveForward = 0.f;
+	float MoveRight = 0.f;
+	float TurnRate = 0.f; //-1..1, scaled by BaseTurnRate like the BaseTurn axis
+	float LookUpRate = 0.f; //-1..1, scaled by BaseLookUpRate like the BaseLookUp axis
+	bool bFire = false;
+	bool bAim = false;
+	bool bUltimate = false;
+	bool bPickup = false;
+};
+
+//Simple combat bot used by the soak harness: wanders, engages the closest character, picks up loose weapons and uses the ultimate.
+//All randomness comes from a seeded stream so a run with the same seed makes the same choices.
+UCLASS()
+class UE5POINT5_SHOOTER_API AMyBotController : public AAIController
+{
+	GENERATED_BODY()
+
+public:
+	AMyBotController();
+	virtual void Tick(float DeltaTime) override;
+	void SetRandomSeed(int32 Seed); //Before possessing, OnPossess staggers the timers with it
+	FORCEINLINE const FMyBotInput& GetLastInput() const { return LastInput; }
+
+protected:
+	virtual void OnPossess(APawn* InPawn) override;
+
+private:
+	FMyBotInput Think(float DeltaTime);
+	class AMyCharacter* FindTarget() const;
+	class AMyWeapon* FindWeaponToPickup() const;
+	void PickNewWanderGoal();
+
+	UPROPERTY()
+	AMyCharacter* Bot;
+	UPROPERTY()
+	AMyCharacter* Target;
+	UPROPERTY()
+	AMyWeapon* WeaponGoal;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot, meta = (AllowPrivateAccess = "true"))
+	float FireInterval;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot, meta = (AllowPrivateAccess = "true"))
+	float UltimateInterval;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot, meta = (AllowPrivateAccess = "true"))
+	float PickupInterval;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot, meta = (AllowPrivateAccess = "true"))
+	float WanderRadius;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot, meta = (AllowPrivateAccess = "true"))
+	float EngageRange;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot, meta = (AllowPrivateAccess = "true"))
+	float PickupSearchRadius;
+
+	FRandomStream Random;
+	FVector HomeLocation;
+	FVector WanderGoal;
+	float TimeToNewWanderGoal;
+	float TimeToRetarget;
+	float TimeToNextShot;
+	float TimeToNextUltimate;
+	float TimeToNextPickup;
+	FMyBotInput LastInput;
+
+	UPROPERTY()
+	class UMyCombatReplaySubsystem* Replay; //Only while recording or playing back a replay
+	int32 ReplayIndex;
+};
@@ -14,10 +14,47 @@
 #include "Components/WidgetComponent.h"
 #include "Components/BoxComponent.h"
 #include "Components/SphereComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/DamageType.h"
+#include "HAL/PlatformTime.h"
+#include "MyHitboxRewindSubsystem.h"
+#include "HAL/IConsoleManager.h"
+#include "MyBotController.h"
+#include "MyCombatStats.h"
+#include "MyProjectileSubsystem.h"
+#include "MyTraceBatch.h"
+#include "MyBallisticsSubsystem.h"
+#include "MyImpactEffectsAsset.h"
+#include "MyDecalPoolSubsystem.h"
+#include "MyCombatAudioSubsystem.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "MyCombatMath.h"
+#include "MyCombatSimSubsystem.h"
+#include "MyActorPoolSubsystem.h"
+#include "MyCombatFXSubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Character Tick"), STAT_ShooterCharacterTick, STATGROUP_ShooterCombat);
+DECLARE_CYCLE_STAT(TEXT("Camera Interp"), STAT_ShooterCameraInterp, STATGROUP_ShooterCombat);
+DECLARE_CYCLE_STAT(TEXT("Trace Items"), STAT_ShooterTraceItems, STATGROUP_ShooterCombat);
+DECLARE_CYCLE_STAT(TEXT("Trace From Crosshair"), STAT_ShooterTraceFromCrosshair, STATGROUP_ShooterCombat);
+DECLARE_CYCLE_STAT(TEXT("Beam End Point"), STAT_ShooterBeamEndPoint, STATGROUP_ShooterCombat);
+DECLARE_CYCLE_STAT(TEXT("Spawn FX"), STAT_ShooterSpawnFX, STATGROUP_ShooterCombat);
+DECLARE_CYCLE_STAT(TEXT("Process Fire Shot"), STAT_ShooterProcessFireShot, STATGROUP_ShooterCombat);
+DECLARE_CYCLE_STAT(TEXT("Fire Pellets"), STAT_ShooterFirePellets, STATGROUP_ShooterCombat);
+DECLARE_CYCLE_STAT(TEXT("Penetrating Shot"), STAT_ShooterPenetratingShot, STATGROUP_ShooterCombat);
+DECLARE_CYCLE_STAT(TEXT("Automatic Shots"), STAT_ShooterAutomaticShots, STATGROUP_ShooterCombat);
+
+static TAutoConsoleVariable<int32> CVarForceCosmetics(
+	TEXT("Shooter.ForceCosmetics"),
+	0,
+	TEXT("1 runs cosmetic work (FX, montages, sounds, camera zoom, item focus) even on a dedicated server.\n")
+	TEXT("Only useful to measure what skipping it saves. Read in BeginPlay."));
 
 
 AMyCharacter::AMyCharacter()
 {
+	LLM_SCOPE_BYTAG(Shooter_Character);
 	PrimaryActorTick.bCanEverTick = true;
 
 	bIsAiming = false;
@@ -26,11 +63,77 @@ AMyCharacter::AMyCharacter()
 
 	ZoomInterpSpeed = 5.f;
 
+	//Ultimate Variables
+	UltimateForceMagnitude = 500.0f;
+	UltimateUpwardForce = 200.0f;
+	UltimateAbilityDelay = 0.5f;
+	UltimateAbilityEmitterDelay = 0.4f;
+	UltimateRocketSpeed = 3000.f;
+	UltimateRocketGravityScale = 0.1f;
+	UltimateRocketRadius = 10.f;
+	UltimateRocketLifetime = 5.f;
+	UltimateDamage = 100.f;
+	UltimateDamageRadius = 300.f;
+
 	BaseTurnRate = 55.f;
 	BaseLookUpRate = 55.f;
 
 	IncrementValueForItemCount = 0;
 	bTraceForHit = false;
+	bCosmeticsEnabled = true;
+	CrosshairOffset = FVector2D::ZeroVector;
+	AimRayFrame = MAX_uint64;
+	TickCycles = 0;
+	NumTicks = 0;
+
+	//Networked Fire Variables
+	PistolDamage = 20.f;
+	MaxMuzzleErrorDistance = 100.f;
+	MaxShotAngleError = 20.f;
+	MaxShotTimeError = 1.f;
+	NextShotSequence = 0;
+	LastServerShotSequence = MAX_uint8; //First shot (0) is one past this
+	LastAcceptedShotTimeStamp = TNumericLimits<float>::Lowest();
+	LastFireTimeStamp = TNumericLimits<float>::Lowest();
+	FireShotBudget = 0.f;
+	FireShotBudgetTime = 0.0;
+	FireShotsSent = 0;
+	FireBitsSent = 0;
+	FireShotsValidated = 0;
+	FireShotsRejected = 0;
+	FireValidationCycles = 0;
+	PenetrationHits.Reserve(PenetrationTraceReserve);
+	PenetrationTraceHighWater = 0;
+	PenetrationHitsGrowths = 0;
+	NumPenetrationHitsResolved = 0;
+	PreviousMuzzleLocation = FVector::ZeroVector;
+	PreviousAimDirection = FVector::ForwardVector;
+	bHasPreviousMuzzle = false;
+	PatternShotCount = 0;
+	LastPatternShotTime = TNumericLimits<float>::Lowest();
+	ServerPatternShotCount = 0;
+	LastServerPatternIndex = 0;
+	RecoilKick = FRotator::ZeroRotator;
+	RecoilRecoverySpeed = 8.f;
+	ImpactEffects = nullptr;
+	ImpactLookupCycles = 0;
+	ImpactLookups = 0;
+	for (int32 Surfaces = 0; Surfaces < MaxPenetrationHits; Surfaces++)
+	{
+		PenetrationCycles[Surfaces] = 0;
+		PenetrationShots[Surfaces] = 0;
+	}
+
+	//Registered and wired up in RegisterActorTickFunctions
+	CameraTick.Work = EMyCharacterTickWork::ECTW_Camera;
+	CameraTick.TickGroup = TG_PostPhysics; //Player camera managers update right after this group, before TG_PostUpdateWork
+	CameraTick.bCanEverTick = true;
+	FocusTick.Work = EMyCharacterTickWork::ECTW_Focus;
+	FocusTick.TickGroup = TG_DuringPhysics;
+	FocusTick.bCanEverTick = true;
+	AnimInputTick.Work = EMyCharacterTickWork::ECTW_AnimInputs;
+	AnimInputTick.TickGroup = TG_PrePhysics;
+	AnimInputTick.bCanEverTick = true;
 
 	CameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("CameraBoom"));
 	CameraBoom->SetupAttachment(RootComponent);
@@ -53,8 +156,34 @@ AMyCharacter::AMyCharacter()
 
 void AMyCharacter::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(Shooter_Character);
 	Super::BeginPlay();
+
+	//A dedicated server never shows anything, so FX, montages, sounds, camera zoom and item focus are skipped at the source
+	//A combat simulation (-CombatSim) runs headless faster than real time, so it skips them the same way
+	bCosmeticsEnabled = (!IsNetMode(NM_DedicatedServer) && !UMyCombatSimSubsystem::IsCombatSimulation()) || CVarForceCosmetics.GetValueOnGameThread() != 0;
+	CameraTick.SetTickFunctionEnable(bCosmeticsEnabled);
+	FocusTick.SetTickFunctionEnable(bCosmeticsEnabled);
+
 	EquipWeapon(DefaultWeaponSpawn());
+	MontagePlayer.Initialize(GetMesh());
+
+	if (UMyProjectileSubsystem* Projectiles = GetWorld()->GetSubsystem<UMyProjectileSubsystem>())
+	{
+		Projectiles->OnProjectileImpact.AddUObject(this, &AMyCharacter::OnProjectileImpact);
+	}
+	if (UMyBallisticsSubsystem* Ballistics = GetWorld()->GetSubsystem<UMyBallisticsSubsystem>())
+	{
+		Ballistics->OnBulletImpact.AddUObject(this, &AMyCharacter::OnBulletImpact);
+	}
+
+	if (HasAuthority())
+	{
+		if (UMyHitboxRewindSubsystem* Rewind = GetWorld()->GetSubsystem<UMyHitboxRewindSubsystem>())
+		{
+			Rewind->RegisterPawn(this); //Lets the server trace shots against our past hitboxes
+		}
+	}
 }
 
 void AMyCharacter::MoveForward(float Value)
@@ -93,34 +222,36 @@ void AMyCharacter::LookUpAtRate(float Rate)
 
 void AMyCharacter::SpawnFX(FName SocketName, UParticleSystem* ParticleFX)
 {
+	SHOOTER_COMBAT_SCOPE(STAT_ShooterSpawnFX);
 	
 	if(!GetWorld())
 	{
 		return;
 	}
 
-	const USkeletalMeshSocket* Socket = GetMesh()->GetSocketByName(SocketName); // Retrieve the socket named by SocketName from the skeletal mesh
-	if (Socket) // Check if the Socket is valid (not null)
+	FTransform SocketTransform; // Get the transform (location, rotation, scale) of the socket
+	if (SocketCache.GetSocketTransform(GetMesh(), SocketName, SocketTransform)) // Check if the mesh has the socket
 	{
-		const FTransform SocketTransform = Socket->GetSocketTransform(GetMesh()); // Get the transform (location, rotation, scale) of the socket
-		if (ParticleFX) // Check if the particle system (ParticleFX) is valid (not null)
+		if (ParticleFX && bCosmeticsEnabled) // Check if the particle system (ParticleFX) is valid (not null)
 		{
-			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ParticleFX, SocketTransform); // Spawn the particle emitter at the location of the socket's transform
+			SpawnCombatEmitter(ParticleFX, SocketTransform); // Spawn the particle emitter at the location of the socket's transform
 		}
 
-		FVector BeamEndPoint;
+		FVector BeamEndPoint = MyCombatMath::ShotTraceEnd(SocketTransform.GetLocation(), GetAimRay().Direction); //Overwritten by the crosshair trace
+		FVector AimDirection = GetAimRay().Direction;
+		const uint8 PatternIndex = AdvanceShotPattern(0.f);
 
-		bool bBeamEndPoint = GetBeamEndPointLocation(SocketTransform.GetLocation(), BeamEndPoint);
+		FHitResult BarrelHitResult;
+		bool bBeamEndPoint = GetBeamEndPointLocation(SocketTransform.GetLocation(), PatternIndex, AimDirection, BeamEndPoint, BarrelHitResult);
 
-		if (bBeamEndPoint)
+		QueueFireShot(SocketTransform.GetLocation(), AimDirection, PatternIndex);
+
+		if (bBeamEndPoint && bCosmeticsEnabled)
 		{
-			if (PistolHitFX)
-			{
-				UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), PistolHitFX, BeamEndPoint);
-			}
+			SpawnImpactEffect(BeamEndPoint, BarrelHitResult.ImpactNormal, UPhysicalMaterial::DetermineSurfaceType(BarrelHitResult.PhysMaterial.Get()));
 
 			FRotator BeamRotation = (BeamEndPoint - SocketTransform.GetLocation()).Rotation(); //Set orientation of the Beam FX
-			UParticleSystemComponent* Beam = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), PistolBeamFX, SocketTransform.GetLocation(), BeamRotation);
+			UParticleSystemComponent* Beam = SpawnCombatEmitter(PistolBeamFX, SocketTransform.GetLocation(), BeamRotation);
 			//if (Beam)
 			//{
 			//	Beam->SetVectorParameter(FName("BeamSource"), SocketTransform.GetLocation()); // Start at muzzle
@@ -129,8 +260,9 @@ void AMyCharacter::SpawnFX(FName SocketName, UParticleSystem* ParticleFX)
 		}
 	}
 }
-bool AMyCharacter::GetBeamEndPointLocation(const FVector& SocketLocation, FVector& BeamEndLocation)
+bool AMyCharacter::GetBeamEndPointLocation(const FVector& SocketLocation, uint8 PatternIndex, FVector& AimDirection, FVector& BeamEndLocation, FHitResult& BarrelHitResult)
 {
+	SHOOTER_COMBAT_SCOPE(STAT_ShooterBeamEndPoint);
 
 	//Trace from Weapon Barrel
 
@@ -146,19 +278,28 @@ bool AMyCharacter::GetBeamEndPointLocation(const FVector& SocketLocation, FVecto
 		//BeamEndLocation is the End location for the line trace. Set in TraceForWidget().
 	}
 
-	FHitResult BarrelHitResult;
 	const FVector WeaponTraceStart = SocketLocation;
-	const FVector VectorFromStartToEnd = BeamEndLocation - SocketLocation;
-	const FVector WeaponTraceEnd = SocketLocation + VectorFromStartToEnd * 2.5f; //Either no hit or hit from crosshair to object in the world
-
-	GetWorld()->LineTraceSingleByChannel(BarrelHitResult, WeaponTraceStart, WeaponTraceEnd, ECollisionChannel::ECC_Visibility);
+	AimDirection = (BeamEndLocation - SocketLocation).GetSafeNormal(); //Barrel to crosshair target, before spread
+	const FVector ShotDirection = EquippedWeapon ? EquippedWeapon->ApplySpread(AimDirection, PatternIndex) : AimDirection;
+	const FVector WeaponTraceEnd = MyCombatMath::ShotTraceEnd(SocketLocation, ShotDirection); //Same range as the crosshair trace, through whatever the crosshair hit
 
-	DrawDebugLine(GetWorld(), WeaponTraceStart, WeaponTraceEnd, FColor::Red, false, 2.0f, 0, 1.5f);
+	FCollisionQueryParams QueryParams;
+	QueryParams.bReturnPhysicalMaterial = WantsImpactSurface();
+	GetWorld()->LineTraceSingleByChannel(BarrelHitResult, WeaponTraceStart, WeaponTraceEnd, ECollisionChannel::ECC_Visibility, QueryParams);
+	MyCombatStats::AddTraces(1);
 
+	if (bCosmeticsEnabled)
+	{
+		DrawDebugLine(GetWorld(), WeaponTraceStart, WeaponTraceEnd, FColor::Red, false, 2.0f, 0, 1.5f);
+	}
 
 	if (BarrelHitResult.bBlockingHit)
 	{
 		BeamEndLocation = BarrelHitResult.Location;
+		if (!bCosmeticsEnabled)
+		{
+			return true; //The log below is for debugging the beam FX, which don't exist then
+		}
 		if(BarrelHitResult.GetActor())
 		{
 			UE_LOG(LogTemp, Warning, TEXT("Beam Hit: %s at %s"), *BarrelHitResult.GetActor()->GetName(), *BarrelHitResult.Location.ToString());
@@ -174,31 +315,48 @@ bool AMyCharacter::GetBeamEndPointLocation(const FVector& SocketLocation, FVecto
 	return false;
 }
 
-bool AMyCharacter::TraceFromCrosshair(FHitResult& HitResult, FVector& HitLocation)
+const FMyAimRay& AMyCharacter::GetAimRay()
 {
-	if (!GEngine || !GEngine->GameViewport)
+	if (AimRayFrame != GFrameCounter)
 	{
-		return false;
+		UpdateAimRay(); //Nobody refreshed it yet this frame (input before Tick, bots, server)
 	}
+	return CachedAimRay;
+}
 
-	FVector2D ViewportSize;
-	GEngine->GameViewport->GetViewportSize(ViewportSize);
-	FVector2D CrosshairLocation(ViewportSize.X / 2.f, ViewportSize.Y / 2.f);
-	FVector CrosshairWorldPosition;
-	FVector CrosshairWorldDirection;
+void AMyCharacter::UpdateAimRay()
+{
+	//The crosshair sits at the screen center (plus CrosshairOffset), which is exactly the camera's forward axis.
+	//Reading the camera transform avoids the viewport query and screen-to-world deprojection, and works without a viewport.
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	if (FollowCamera)
+	{
+		ViewLocation = FollowCamera->GetComponentLocation();
+		ViewRotation = FollowCamera->GetComponentRotation();
+	}
+	else
+	{
+		GetActorEyesViewPoint(ViewLocation, ViewRotation);
+	}
 
-	bool bScreenToWorld = UGameplayStatics::DeprojectScreenToWorld(
-		UGameplayStatics::GetPlayerController(this, 0),
-		CrosshairLocation,
-		CrosshairWorldPosition,
-		CrosshairWorldDirection
-	);
+	FQuat AimRotation = ViewRotation.Quaternion();
+	if (!CrosshairOffset.IsZero())
+	{
+		AimRotation = AimRotation * FRotator(CrosshairOffset.Y, CrosshairOffset.X, 0.f).Quaternion();
+	}
 
-	if (!bScreenToWorld)
-		return false;
+	CachedAimRay.Origin = ViewLocation;
+	CachedAimRay.Direction = AimRotation.GetForwardVector();
+	AimRayFrame = GFrameCounter;
+}
 
-	const FVector Start = CrosshairWorldPosition;
-	const FVector End = Start + CrosshairWorldDirection * 50'000.f;
+bool AMyCharacter::TraceFromCrosshair(FHitResult& HitResult, FVector& HitLocation)
+{
+	SHOOTER_COMBAT_SCOPE(STAT_ShooterTraceFromCrosshair);
+	const FMyAimRay& AimRay = GetAimRay();
+	const FVector Start = AimRay.Origin;
+	const FVector End = MyCombatMath::ShotTraceEnd(Start, AimRay.Direction);
 
 	HitLocation = End; // Default to End if no hit occurs
 
@@ -212,8 +370,12 @@ bool AMyCharacter::TraceFromCrosshair(FHitResult& HitResult, FVector& HitLocatio
 		ECollisionChannel::ECC_Camera,
 		QueryParams
 	);
+	MyCombatStats::AddTraces(1);
 
-	DrawDebugLine(GetWorld(), Start, End, FColor::Green, false, 2.0f, 0, 1.5f);
+	if (bCosmeticsEnabled)
+	{
+		DrawDebugLine(GetWorld(), Start, End, FColor::Green, false, 2.0f, 0, 1.5f);
+	}
 
 	if (bHit && HitResult.bBlockingHit)
 	{
@@ -241,6 +403,7 @@ void AMyCharacter::SpawnBeamFX(FVector Start, FVector End)
 
 void AMyCharacter::TraceItems()
 {
+	SHOOTER_COMBAT_CSV_SCOPE(STAT_ShooterTraceItems, TraceItems);
 	if (bTraceForHit)
 	{
 		FHitResult WidgetHitResult;
@@ -249,9 +412,10 @@ void AMyCharacter::TraceItems()
 		if (WidgetHitResult.bBlockingHit)
 		{
 			AMyItem* Item = Cast<AMyItem>(WidgetHitResult.GetActor());
-			if (Item && Item->ReturnWeaponWidget())
+			if (Item)
 			{
-				Item->ReturnWeaponWidget()->SetVisibility(true);
+				Item->ShowWeaponWidget(true);
+				MyCombatStats::AddItemInFocus();
 			}
 			if(MyItemLastFrame)
 			{
@@ -260,7 +424,7 @@ void AMyCharacter::TraceItems()
 					//We are hitting a different AItem this frame from last frame
 					//OR
 					//AItem is null
-					MyItemLastFrame->ReturnWeaponWidget()->SetVisibility(false);
+					MyItemLastFrame->ShowWeaponWidget(false);
 				}
 			}
 			MyItemLastFrame = Item; //Store a reference to Item for next frame
@@ -270,31 +434,177 @@ void AMyCharacter::TraceItems()
 	{
 		//No longer overlapping any items,
 		//Item last frame should not show widget
-		MyItemLastFrame->ReturnWeaponWidget()->SetVisibility(false);
+		MyItemLastFrame->ShowWeaponWidget(false);
 	}
 }
 
 
 void AMyCharacter::PlayAnimation(UAnimMontage* AnimationMontage, FName SectionName)
 {
-	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
-	if (AnimationMontage && AnimInstance)
+	if (!bCosmeticsEnabled)
+	{
+		return;
+	}
+	MontagePlayer.Play(AnimationMontage, SectionName);
+}
+
+void AMyCharacter::PlaySound(USoundBase* SoundCue, EMyCombatSoundGroup Group)
+{
+	if (!bCosmeticsEnabled)
+	{
+		return;
+	}
+	if (UMyCombatAudioSubsystem* CombatAudio = GetWorld()->GetSubsystem<UMyCombatAudioSubsystem>())
+	{
+		CombatAudio->PlayCombatSound(SoundCue, GetActorLocation(), Group, this);
+	}
+}
+
+EMyCombatSoundGroup AMyCharacter::GetWeaponSoundGroup() const
+{
+	switch (EquippedWeapon ? EquippedWeapon->GetFireMode() : EWeaponFireMode::EWFM_SingleShot)
+	{
+	case EWeaponFireMode::EWFM_PelletSpread:
+		return EMyCombatSoundGroup::ECSG_PelletSpread;
+	case EWeaponFireMode::EWFM_Penetrating:
+		return EMyCombatSoundGroup::ECSG_Penetrating;
+	case EWeaponFireMode::EWFM_Ballistic:
+		return EMyCombatSoundGroup::ECSG_Ballistic;
+	default:
+		return EMyCombatSoundGroup::ECSG_SingleShot;
+	}
+}
+
+void AMyCharacter::FireButtonPressed()
+{
+	if (EquippedWeapon && EquippedWeapon->IsAutomatic())
+	{
+		FireScheduler.Start(); //Shots go out from Tick
+	}
+	else if (!EquippedWeapon || GetFireTimeStamp() - LastFireTimeStamp >= EquippedWeapon->GetShotInterval())
 	{
-		AnimInstance->Montage_Play(AnimationMontage);
-		AnimInstance->Montage_JumpToSection(SectionName);
+		FirePistol(); //Clicking faster than the weapon's rate would only get the shots rejected by the server
 	}
 }
 
-void AMyCharacter::PlaySound(USoundBase* SoundCue)
+void AMyCharacter::FireButtonReleased()
 {
-	UGameplayStatics::PlaySound2D(this, SoundCue);
+	FireScheduler.Stop();
 }
 
 void AMyCharacter::FirePistol() // Functionality for firing pistol
 {
-	SpawnFX("gunMuzzleSocket", PistolMuzzleFX);
+	if (EquippedWeapon && EquippedWeapon->GetFireMode() == EWeaponFireMode::EWFM_PelletSpread)
+	{
+		FirePellets();
+	}
+	else if (EquippedWeapon && EquippedWeapon->GetFireMode() == EWeaponFireMode::EWFM_Penetrating)
+	{
+		FirePenetrating();
+	}
+	else if (EquippedWeapon && EquippedWeapon->GetFireMode() == EWeaponFireMode::EWFM_Ballistic)
+	{
+		FireBallistic();
+	}
+	else
+	{
+		SpawnFX("gunMuzzleSocket", PistolMuzzleFX);
+	}
 	PlayAnimation(PistolFireMontage, "Fire");
-	PlaySound(PistolSoundCue);
+	PlaySound(PistolSoundCue, GetWeaponSoundGroup());
+}
+
+void AMyCharacter::UltimateFire()
+{
+	if (GetWorldTimerManager().IsTimerActive(PlayerInputTimeHandle))
+	{
+		return; //Ultimate still playing
+	}
+	MyCombatStats::AddUltimateUsed();
+
+	//Disable Player Inputs
+	APlayerController* PlayerController = Cast<APlayerController>(GetController());
+	if (PlayerController)
+	{
+		PlayerController->DisableInput(PlayerController);
+	}
+
+	PlayAnimation(UltimateFireMontage, "Ultimate");
+	float DelayForAnimationDuration = UltimateFireMontage ? UltimateFireMontage->GetPlayLength() : FMath::Max(UltimateAbilityDelay, UltimateAbilityEmitterDelay);
+
+	GetWorldTimerManager().SetTimer(PlayerInputTimeHandle, this, &AMyCharacter::EnablePlayerInput, DelayForAnimationDuration, false);
+	GetWorldTimerManager().SetTimer(UltimateHandle, this, &AMyCharacter::DelayedUltimateAbility, UltimateAbilityDelay, false);
+	GetWorldTimerManager().SetTimer(UltimateEmitterHandle, this, &AMyCharacter::DelayedUltimateAbilityEmitter, UltimateAbilityEmitterDelay, false);
+}
+
+void AMyCharacter::ApplyForceWhenUltimateIsUsed(float ForceMagnitude, float UpwardForce)
+{
+	FVector LaunchDirection = GetActorForwardVector();
+	LaunchDirection.Normalize();
+
+	FVector Force = -LaunchDirection * ForceMagnitude + FVector(0.f, 0.f, UpwardForce);
+
+	GetCharacterMovement()->AddImpulse(Force, true);
+}
+
+void AMyCharacter::EnablePlayerInput()
+{
+	APlayerController* PlayerController = Cast<APlayerController>(GetController());
+	if (PlayerController)
+	{
+		PlayerController->EnableInput(PlayerController);
+	}
+}
+
+void AMyCharacter::DelayedUltimateAbility()
+{
+	ApplyForceWhenUltimateIsUsed(UltimateForceMagnitude, UltimateUpwardForce);
+}
+
+void AMyCharacter::DelayedUltimateAbilityEmitter()
+{
+	LaunchUltimateRocket(); // Functionality for firing ultimate ability
+	PlaySound(UltimateSoundCue, EMyCombatSoundGroup::ECSG_Ultimate);
+}
+
+void AMyCharacter::LaunchUltimateRocket()
+{
+	UMyProjectileSubsystem* Projectiles = GetWorld()->GetSubsystem<UMyProjectileSubsystem>();
+	FTransform SocketTransform;
+	if (!Projectiles || !SocketCache.GetSocketTransform(GetMesh(), "bazookaMuzzle", SocketTransform))
+	{
+		return;
+	}
+
+	if (UltimateMuzzleFX && bCosmeticsEnabled)
+	{
+		SpawnCombatEmitter(UltimateMuzzleFX, SocketTransform);
+	}
+
+	//Rocket flies from the bazooka towards whatever is under the crosshair
+	FHitResult CrosshairHitResult;
+	FVector TargetLocation;
+	TraceFromCrosshair(CrosshairHitResult, TargetLocation);
+	const FVector LaunchDirection = (TargetLocation - SocketTransform.GetLocation()).GetSafeNormal();
+
+	Projectiles->LaunchProjectile(SocketTransform.GetLocation(), LaunchDirection * UltimateRocketSpeed, this, UltimateRocketRadius, UltimateRocketLifetime, UltimateRocketGravityScale);
+}
+
+void AMyCharacter::OnProjectileImpact(const FMyProjectileImpact& Impact)
+{
+	if (Impact.Instigator.Get() != this)
+	{
+		return; //Someone else's rocket
+	}
+
+	if (UltimateImpactFX && bCosmeticsEnabled)
+	{
+		SpawnCombatEmitter(UltimateImpactFX, Impact.Location, Impact.Normal.Rotation());
+	}
+	if (HasAuthority())
+	{
+		UGameplayStatics::ApplyRadialDamage(this, UltimateDamage, Impact.Location, UltimateDamageRadius, UDamageType::StaticClass(), TArray<AActor*>(), this, GetController());
+	}
 }
 
 void AMyCharacter::AimingPressed()
@@ -309,13 +619,14 @@ void AMyCharacter::AimingReleased()
 
 void AMyCharacter::CameraInterp(float DeltaTime)
 {
+	SHOOTER_COMBAT_SCOPE(STAT_ShooterCameraInterp);
 	TargetCamLocation = bIsAiming ? FVector(180.f, 0.f, 40.f) : FVector(0.f, 0.f, 0.f); //If true sets FVector(250.f, 0.f, -50.f), if false sets FVector(0.f, 0.f, 0.f)
-	TargetCamRotation = bIsAiming ? FRotator(0.f, 0.f, 0.f) : FRotator(0.f, 0.f, 0.f);
+	TargetCamRotation = RecoilKick;
 	float TargetFOV = bIsAiming ? 75.f : 90.f;
 
-	FVector NewCamLocation = FMath::VInterpTo(FollowCamera->GetRelativeLocation(), TargetCamLocation, DeltaTime, ZoomInterpSpeed);
-	FRotator NewCamRotation = FMath::RInterpTo(FollowCamera->GetRelativeRotation(), TargetCamRotation, DeltaTime, ZoomInterpSpeed);
-	float NewFOV = FMath::FInterpTo(FollowCamera->FieldOfView, TargetFOV, DeltaTime, ZoomInterpSpeed);
+	FVector NewCamLocation = MyCombatMath::VectorInterpTo(FollowCamera->GetRelativeLocation(), TargetCamLocation, DeltaTime, ZoomInterpSpeed);
+	FRotator NewCamRotation = MyCombatMath::RotatorInterpTo(FollowCamera->GetRelativeRotation(), TargetCamRotation, DeltaTime, ZoomInterpSpeed);
+	float NewFOV = MyCombatMath::InterpTo(FollowCamera->FieldOfView, TargetFOV, DeltaTime, ZoomInterpSpeed);
 
 	FollowCamera->SetRelativeLocation(NewCamLocation);
 	FollowCamera->SetRelativeRotation(NewCamRotation);
@@ -326,8 +637,13 @@ void AMyCharacter::CameraInterp(float DeltaTime)
 
 AMyWeapon* AMyCharacter::DefaultWeaponSpawn()
 {
+	LLM_SCOPE_BYTAG(Shooter_Weapons);
 	if(BaseWeaponClass) //Checking if TSubclassOf variable is valid, if true then
 	{
+		if (UMyActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UMyActorPoolSubsystem>())
+		{
+			return Pool->Acquire<AMyWeapon>(BaseWeaponClass, FTransform::Identity); //Reusing a pooled weapon when there is one
+		}
 		return GetWorld()->SpawnActor<AMyWeapon>(BaseWeaponClass); //Spawning default weapon into the world
 	}
 	return nullptr;
@@ -347,11 +663,273 @@ void AMyCharacter::EquipWeapon(AMyWeapon* WeaponToEquip)
 	WeaponToEquip->ReturnSphereDetector()->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 }
 
+void AMyCharacter::DropWeapon()
+{
+	if (!EquippedWeapon) return;
+
+	FDetachmentTransformRules DetachmentTransformRules(EDetachmentRule::KeepWorld, true);
+	EquippedWeapon->DetachFromActor(DetachmentTransformRules);
+	EquippedWeapon->SetActorLocation(GetActorLocation() + GetActorForwardVector() * 100.f - FVector(0.f, 0.f, GetCapsuleComponent()->GetScaledCapsuleHalfHeight()));
+	EquippedWeapon->SetStateOfItem(EStateOfItem::ESOI_NotEquipped);
+	EquippedWeapon = nullptr;
+}
+
+bool AMyCharacter::PickupItem(AMyItem* Item)
+{
+	AMyWeapon* Weapon = Cast<AMyWeapon>(Item);
+	if (!Weapon || Weapon->GetStateOfItem() != EStateOfItem::ESOI_NotEquipped)
+	{
+		return false;
+	}
+
+	if (Weapon == MyItemLastFrame)
+	{
+		Weapon->ShowWeaponWidget(false);
+		MyItemLastFrame = nullptr;
+	}
+	DropWeapon();
+	EquipWeapon(Weapon);
+	MyCombatStats::AddItemPickedUp();
+	return true;
+}
+
+AMyItem* AMyCharacter::FindPickupCandidate() const
+{
+	if (MyItemLastFrame && bTraceForHit)
+	{
+		return MyItemLastFrame; //Item under the crosshair
+	}
+
+	//Without a crosshair focus (bots, servers) take the closest overlapped item
+	TArray<AActor*> OverlappingItems;
+	GetOverlappingActors(OverlappingItems, AMyItem::StaticClass());
+	AMyItem* ClosestItem = nullptr;
+	float ClosestDistanceSquared = TNumericLimits<float>::Max();
+	for (AActor* Actor : OverlappingItems)
+	{
+		AMyItem* Item = Cast<AMyItem>(Actor);
+		const float DistanceSquared = FVector::DistSquared(Actor->GetActorLocation(), GetActorLocation());
+		if (Item && Item->GetStateOfItem() == EStateOfItem::ESOI_NotEquipped && DistanceSquared < ClosestDistanceSquared)
+		{
+			ClosestItem = Item;
+			ClosestDistanceSquared = DistanceSquared;
+		}
+	}
+	return ClosestItem;
+}
+
+void AMyCharacter::SelectButtonPressed()
+{
+	PickupItem(FindPickupCandidate());
+}
+
+void AMyCharacter::ApplyBotInput(const FMyBotInput& Input, float DeltaTime)
+{
+	MoveForward(Input.MoveForward);
+	MoveRight(Input.MoveRight);
+
+	//AddControllerYawInput only works for player controllers, so bots rotate their controller directly
+	if (Controller && (Input.TurnRate != 0.f || Input.LookUpRate != 0.f))
+	{
+		FRotator ControlRotation = Controller->GetControlRotation();
+		ControlRotation.Yaw += Input.TurnRate * BaseTurnRate * DeltaTime;
+		ControlRotation.Pitch = FMath::ClampAngle(ControlRotation.Pitch + Input.LookUpRate * BaseLookUpRate * DeltaTime, -89.f, 89.f);
+		Controller->SetControlRotation(ControlRotation);
+	}
+
+	if (Input.bAim != bIsAiming)
+	{
+		Input.bAim ? AimingPressed() : AimingReleased();
+	}
+	if (Input.bPickup)
+	{
+		SelectButtonPressed();
+	}
+	if (Input.bFire)
+	{
+		FirePistol();
+	}
+	if (Input.bUltimate)
+	{
+		UltimateFire();
+	}
+}
+
 void AMyCharacter::Tick(float DeltaTime)
 {
+	SHOOTER_COMBAT_CSV_SCOPE(STAT_ShooterCharacterTick, CharacterTick);
+	LLM_SCOPE_BYTAG(Shooter_Character); //Scratch arrays grow here
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
 	Super::Tick(DeltaTime);
-	CameraInterp(DeltaTime);
-	TraceItems();
+	if (IsLocallyControlled())
+	{
+		UpdateAutomaticFire(DeltaTime);
+	}
+	FlushFireShots(); //Shots fired during this tick leave as a single RPC
+	MyCombatStats::AddOverlappedItems(IncrementValueForItemCount);
+
+	TickCycles += FPlatformTime::Cycles64() - StartCycles;
+	NumTicks++;
+}
+
+void AMyCharacter::RegisterActorTickFunctions(bool bRegister)
+{
+	Super::RegisterActorTickFunctions(bRegister);
+
+	FMyCharacterTickFunction* const TickFunctions[] = { &CameraTick, &FocusTick, &AnimInputTick };
+	if (!bRegister)
+	{
+		for (FMyCharacterTickFunction* TickFunction : TickFunctions)
+		{
+			if (TickFunction->IsTickFunctionRegistered())
+			{
+				TickFunction->UnRegisterTickFunction();
+			}
+		}
+		return;
+	}
+
+	for (FMyCharacterTickFunction* TickFunction : TickFunctions)
+	{
+		TickFunction->Character = this;
+		TickFunction->RegisterTickFunction(GetLevel());
+	}
+
+	//Anim inputs: after movement moved us, before the mesh runs the anim update that reads them
+	UCharacterMovementComponent* Movement = GetCharacterMovement();
+	AnimInputTick.AddPrerequisite(Movement, Movement->PrimaryComponentTick);
+	GetMesh()->PrimaryComponentTick.AddPrerequisite(this, AnimInputTick);
+
+	//Item focus: only needs our final position, so it traces while physics simulates instead of blocking before it.
+	//The camera tick hasn't run yet this frame, so GetAimRay recomputes the ray from the camera as it is now:
+	//moved with us, but still on last frame's boom rotation and camera interp. Near enough to pick the item under the crosshair.
+	FocusTick.AddPrerequisite(Movement, Movement->PrimaryComponentTick);
+
+	//Camera: after the boom applied this frame's control rotation and our own tick queued this frame's recoil,
+	//and in TG_PostPhysics so it lands before the camera manager reads the view. The aim ray it refreshes is the rendered view.
+	CameraTick.AddPrerequisite(CameraBoom, CameraBoom->PrimaryComponentTick);
+	CameraTick.AddPrerequisite(this, PrimaryActorTick);
+}
+
+void FMyCharacterTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (!Character || !IsValid(Character) || TickType == LEVELTICK_ViewportsOnly)
+	{
+		return;
+	}
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	switch (Work)
+	{
+	case EMyCharacterTickWork::ECTW_Camera:
+		Character->TickCamera(DeltaTime);
+		break;
+	case EMyCharacterTickWork::ECTW_Focus:
+		Character->TickFocus(DeltaTime);
+		break;
+	case EMyCharacterTickWork::ECTW_AnimInputs:
+		Character->GatherAnimInputs(DeltaTime);
+		break;
+	}
+	Character->TickCycles += FPlatformTime::Cycles64() - StartCycles;
+}
+
+FString FMyCharacterTickFunction::DiagnosticMessage()
+{
+	static const TCHAR* WorkNames[] = { TEXT("Camera"), TEXT("Focus"), TEXT("AnimInputs") };
+	return FString::Printf(TEXT("%s[%s]"), Character ? *Character->GetFullName() : TEXT("AMyCharacter"), WorkNames[static_cast<uint8>(Work)]);
+}
+
+void AMyCharacter::TickCamera(float DeltaTime)
+{
+	//Kick settles back while not firing. Outside the gate: AI on the server is locally controlled and builds up kick too
+	RecoilKick = MyCombatMath::RotatorInterpTo(RecoilKick, FRotator::ZeroRotator, DeltaTime, RecoilRecoverySpeed);
+	if (bCosmeticsEnabled && IsPlayerControlled() && IsLocallyControlled())
+	{
+		CameraInterp(DeltaTime); //Bots have nobody looking through their camera
+		UpdateAimRay(); //Everyone else refreshes lazily through GetAimRay
+	}
+}
+
+void AMyCharacter::TickFocus(float DeltaTime)
+{
+	if (bCosmeticsEnabled && IsPlayerControlled() && IsLocallyControlled())
+	{
+		TraceItems(); //Nor at their item widgets
+	}
+}
+
+void AMyCharacter::GatherAnimInputs(float DeltaTime)
+{
+	const FVector Velocity = GetVelocity();
+	AnimInputs.Speed = Velocity.Size2D();
+	AnimInputs.bIsMoving = !Velocity.IsZero();
+	AnimInputs.bIsAccelerating = GetCharacterMovement()->GetCurrentAcceleration().SizeSquared() > 0.f;
+	AnimInputs.StrafeValue = MyCombatMath::StrafeYaw(Velocity.X, Velocity.Y, GetBaseAimRotation().Yaw);
+	AnimInputs.bIsAiming = bIsAiming;
+}
+
+void AMyCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (NumTicks > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s tick: %.2f us average over %d ticks (cosmetics %s)"),
+			*GetName(), FPlatformTime::ToMilliseconds64(TickCycles) * 1000.0 / NumTicks, NumTicks, bCosmeticsEnabled ? TEXT("on") : TEXT("off"));
+	}
+	if (FireShotsSent > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s fire RPC: %d shots sent, %.1f bytes per shot"),
+			*GetName(), FireShotsSent, FireBitsSent / 8.0 / FireShotsSent);
+	}
+	if (FireShotsValidated + FireShotsRejected > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s fire validation: %d accepted, %d rejected, %.2f us per shot"),
+			*GetName(), FireShotsValidated, FireShotsRejected,
+			FPlatformTime::ToMilliseconds64(FireValidationCycles) * 1000.0 / (FireShotsValidated + FireShotsRejected));
+	}
+	if (MontagePlayer.GetInstancesStarted() + MontagePlayer.GetRestarts() > 0)
+	{
+		const double Seconds = FMath::Max(static_cast<double>(GetGameTimeSinceCreation()), 1.0);
+		UE_LOG(LogTemp, Log, TEXT("%s montages: %.2f instances started per second, %.2f restarts per second"),
+			*GetName(), MontagePlayer.GetInstancesStarted() / Seconds, MontagePlayer.GetRestarts() / Seconds);
+	}
+	if (ImpactLookups > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s impact effects: %lld lookups, %.1f ns per lookup"),
+			*GetName(), ImpactLookups, FPlatformTime::ToMilliseconds64(ImpactLookupCycles) * 1'000'000.0 / ImpactLookups);
+	}
+	if (PenetrationTraceHighWater > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s penetration traces: up to %d hits per trace, reserved %d, grew %d times"),
+			*GetName(), PenetrationTraceHighWater, PenetrationTraceReserve, PenetrationHitsGrowths);
+	}
+	for (int32 Surfaces = 0; Surfaces < MaxPenetrationHits; Surfaces++)
+	{
+		if (PenetrationShots[Surfaces] > 0)
+		{
+			UE_LOG(LogTemp, Log, TEXT("%s penetration: %d shots through %d surfaces, %.2f us per shot"),
+				*GetName(), PenetrationShots[Surfaces], Surfaces, FPlatformTime::ToMilliseconds64(PenetrationCycles[Surfaces]) * 1000.0 / PenetrationShots[Surfaces]);
+		}
+	}
+	if (UMyHitboxRewindSubsystem* Rewind = GetWorld()->GetSubsystem<UMyHitboxRewindSubsystem>())
+	{
+		Rewind->UnregisterPawn(this);
+	}
+	if (UMyProjectileSubsystem* Projectiles = GetWorld()->GetSubsystem<UMyProjectileSubsystem>())
+	{
+		Projectiles->OnProjectileImpact.RemoveAll(this);
+	}
+	if (UMyBallisticsSubsystem* Ballistics = GetWorld()->GetSubsystem<UMyBallisticsSubsystem>())
+	{
+		Ballistics->OnBulletImpact.RemoveAll(this);
+	}
+	UMyActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UMyActorPoolSubsystem>();
+	if (Pool && EquippedWeapon && EndPlayReason == EEndPlayReason::Destroyed)
+	{
+		Pool->ReleaseActor(EquippedWeapon); //Our weapon goes back for the next character instead of staying attached to nothing
+		EquippedWeapon = nullptr;
+	}
+	Super::EndPlay(EndPlayReason);
 }
 
 void AMyCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -365,7 +943,10 @@ void AMyCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCompone
 	PlayerInputComponent->BindAxis("BaseLookUp", this, &AMyCharacter::LookUpAtRate);
 	PlayerInputComponent->BindAxis("Turn", this, &APawn::AddControllerYawInput); //Mouse Y Movement
 	PlayerInputComponent->BindAxis("LookUp", this, &APawn::AddControllerPitchInput); //Mouse X Movement
-	PlayerInputComponent->BindAction("FirePistol", EInputEvent::IE_Pressed, this, &AMyCharacter::FirePistol);
+	PlayerInputComponent->BindAction("FirePistol", EInputEvent::IE_Pressed, this, &AMyCharacter::FireButtonPressed);
+	PlayerInputComponent->BindAction("FirePistol", EInputEvent::IE_Released, this, &AMyCharacter::FireButtonReleased);
+	PlayerInputComponent->BindAction("UltimateAbility", EInputEvent::IE_Pressed, this, &AMyCharacter::UltimateFire);
+	PlayerInputComponent->BindAction("Select", EInputEvent::IE_Pressed, this, &AMyCharacter::SelectButtonPressed);
 	PlayerInputComponent->BindAction("Aiming", EInputEvent::IE_Pressed, this, &AMyCharacter::AimingPressed);
 	PlayerInputComponent->BindAction("Aiming", EInputEvent::IE_Released, this, &AMyCharacter::AimingReleased);
 }
@@ -383,3 +964,804 @@ void AMyCharacter::IncrementOverlappedItemCount(int8 Value)
 		bTraceForHit = true;
 	}
 }
+
+
+void AMyCharacter::QueueFireShot(const FVector& MuzzleLocation, const FVector& ShotDirection, uint8 PatternIndex, float TimeBeforeNow)
+{
+	MyCombatStats::AddShotFired();
+
+	FMyFireShot Shot;
+	Shot.MuzzleLocation = MuzzleLocation;
+	Shot.ShotDirection = ShotDirection;
+	Shot.ShotSequence = NextShotSequence++;
+	Shot.PatternIndex = PatternIndex;
+	Shot.ClientTimeStamp = GetFireTimeStamp() - TimeBeforeNow;
+	LastFireTimeStamp = Shot.ClientTimeStamp; //Same clock the server checks the fire rate on
+
+	if (HasAuthority())
+	{
+		ProcessFireShot(Shot); //Standalone or listen server host, nothing to send
+		return;
+	}
+	PendingFireShots.Add(Shot);
+}
+
+float AMyCharacter::GetFireTimeStamp() const
+{
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	return static_cast<float>(GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds());
+}
+
+void AMyCharacter::FlushFireShots()
+{
+	if (PendingFireShots.Num() == 0)
+	{
+		return;
+	}
+
+#if !UE_BUILD_SHIPPING
+	FNetBitWriter SizeWriter(nullptr, 256);
+	for (FMyFireShot& Shot : PendingFireShots)
+	{
+		bool bSuccess = true;
+		Shot.NetSerialize(SizeWriter, nullptr, bSuccess);
+	}
+	FireBitsSent += SizeWriter.GetNumBits();
+#endif
+	FireShotsSent += PendingFireShots.Num();
+
+	ServerFireShots(PendingFireShots);
+	PendingFireShots.Reset(); //Keeps the allocation for the next tick
+}
+
+float AMyCharacter::GetServerShotInterval() const
+{
+	static constexpr float UnarmedShotInterval = 0.1f; //Same as a 600 RPM weapon
+	return EquippedWeapon ? EquippedWeapon->GetShotInterval() : UnarmedShotInterval;
+}
+
+int32 AMyCharacter::GetMaxShotsPerFireRPC() const
+{
+	//Shots are flushed every tick, the longest a legit client can bunch up is one net update at the slowest rate
+	const float NetUpdatePeriod = 1.f / FMath::Max(GetMinNetUpdateFrequency(), 1.f);
+	return FMath::CeilToInt(NetUpdatePeriod / GetServerShotInterval()) + 1;
+}
+
+void AMyCharacter::ServerFireShots_Implementation(const TArray<FMyFireShot>& Shots)
+{
+	//Anything past what the weapon can fire in one update is dropped unprocessed
+	const int32 MaxShots = GetMaxShotsPerFireRPC();
+	for (int32 Index = 0; Index < Shots.Num(); Index++)
+	{
+		if (Index < MaxShots)
+		{
+			ProcessFireShot(Shots[Index]);
+		}
+		else
+		{
+			FireShotsRejected++;
+		}
+	}
+}
+
+void AMyCharacter::ProcessFireShot(const FMyFireShot& Shot)
+{
+	SHOOTER_COMBAT_CSV_SCOPE(STAT_ShooterProcessFireShot, ProcessFireShot);
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	ShotHits.Reset();
+	const bool bValidShot = ValidateFireShot(Shot);
+	const FVector SpreadDirection = bValidShot && EquippedWeapon ? EquippedWeapon->ApplySpread(Shot.ShotDirection, LastServerPatternIndex) : Shot.ShotDirection; //Same table lookup as the client
+	if (bValidShot && EquippedWeapon && EquippedWeapon->GetFireMode() == EWeaponFireMode::EWFM_Penetrating)
+	{
+		TracePenetratingShot(Shot.MuzzleLocation, SpreadDirection, Shot.ClientTimeStamp, true);
+	}
+	else if (bValidShot && EquippedWeapon && EquippedWeapon->GetFireMode() == EWeaponFireMode::EWFM_Ballistic)
+	{
+		//The bullet flies in the server's present, it is not traced against rewound hitboxes
+		if (UMyBallisticsSubsystem* Ballistics = GetWorld()->GetSubsystem<UMyBallisticsSubsystem>())
+		{
+			Ballistics->LaunchBullet(Shot.MuzzleLocation, SpreadDirection * EquippedWeapon->GetMuzzleVelocity(), this, EquippedWeapon->GetBulletLifetime(), EquippedWeapon->GetBulletGravityScale());
+		}
+	}
+	else if (bValidShot)
+	{
+		//Pellet weapons fan out around the spread direction with the same pattern the client used
+		const bool bPellets = EquippedWeapon && EquippedWeapon->GetFireMode() == EWeaponFireMode::EWFM_PelletSpread;
+		if (bPellets)
+		{
+			EquippedWeapon->GetPelletDirections(SpreadDirection, Shot.ShotSequence, ShotDirections);
+		}
+		else
+		{
+			ShotDirections.Reset();
+			ShotDirections.Add(SpreadDirection);
+		}
+		ServerTraceShot(Shot.MuzzleLocation, Shot.ClientTimeStamp, ShotDirections, ShotHits);
+		ApplyShotDamage(ShotHits, SpreadDirection, bPellets ? EquippedWeapon->GetPelletDamage() : PistolDamage);
+	}
+
+	FireValidationCycles += FPlatformTime::Cycles64() - StartCycles;
+	bValidShot ? FireShotsValidated++ : FireShotsRejected++;
+}
+
+bool AMyCharacter::ValidateFireShot(const FMyFireShot& Shot)
+{
+	//Sequence must move forward, drops duplicated and reordered shots
+	if (!IsNewerShotSequence(Shot.ShotSequence, LastServerShotSequence))
+	{
+		return false;
+	}
+
+	if (FMath::Abs(GetFireTimeStamp() - Shot.ClientTimeStamp) > MaxShotTimeError)
+	{
+		return false;
+	}
+
+	//The server walks the pattern from the shots it accepted, a client can't claim an easier part of the spread
+	const int32 ServerPatternIndex = EquippedWeapon ? EquippedWeapon->GetPatternIndex(ServerPatternShotCount, Shot.ClientTimeStamp - LastAcceptedShotTimeStamp) : 0;
+	if (Shot.PatternIndex != ServerPatternIndex)
+	{
+		return false;
+	}
+
+	//Claimed muzzle has to be close to where the server has the muzzle socket
+	FVector ServerMuzzle;
+	if (!SocketCache.GetSocketLocation(GetMesh(), "gunMuzzleSocket", ServerMuzzle))
+	{
+		ServerMuzzle = GetPawnViewLocation();
+	}
+	if (FVector::DistSquared(ServerMuzzle, Shot.MuzzleLocation) > FMath::Square(MaxMuzzleErrorDistance))
+	{
+		return false;
+	}
+
+	//Barrel to crosshair converges, so the direction only has to roughly match the replicated aim
+	const float CosAngle = FVector::DotProduct(Shot.ShotDirection, GetBaseAimRotation().Vector());
+	if (CosAngle < FMath::Cos(FMath::DegreesToRadians(MaxShotAngleError)))
+	{
+		return false;
+	}
+
+	//Fire rate: claimed timestamps have to be a shot interval apart, and the total can't outrun server time either
+	static constexpr float ShotIntervalTolerance = 0.001f; //Float timestamps of consecutive automatic shots
+	const float ShotInterval = GetServerShotInterval();
+	if (Shot.ClientTimeStamp - LastAcceptedShotTimeStamp < ShotInterval - ShotIntervalTolerance)
+	{
+		return false;
+	}
+	const double Now = GetWorld()->GetTimeSeconds();
+	FireShotBudget = FMath::Min(FireShotBudget + static_cast<float>(Now - FireShotBudgetTime) / ShotInterval, static_cast<float>(GetMaxShotsPerFireRPC()));
+	FireShotBudgetTime = Now;
+	if (FireShotBudget < 1.f)
+	{
+		return false;
+	}
+	FireShotBudget -= 1.f;
+
+	//Only accepted shots move the server's view of the client forward, a rejected one leaves nothing behind
+	LastServerShotSequence = Shot.ShotSequence;
+	ServerPatternShotCount = ServerPatternIndex + 1;
+	LastServerPatternIndex = static_cast<uint8>(ServerPatternIndex);
+	LastAcceptedShotTimeStamp = Shot.ClientTimeStamp;
+	return true;
+}
+
+void AMyCharacter::ServerTraceShot(const FVector& MuzzleLocation, float ClientTimeStamp, TArrayView<const FVector> Directions, TArray<FHitResult>& OutHits)
+{
+	//Re-run the barrel traces on the server. Pawns are checked where they were when the client fired, not where they are now.
+	UMyHitboxRewindSubsystem* Rewind = GetWorld()->GetSubsystem<UMyHitboxRewindSubsystem>();
+	FCollisionQueryParams QueryParams;
+	QueryParams.AddIgnoredActor(this);
+	if (Rewind)
+	{
+		Rewind->AddIgnoredPawns(QueryParams);
+	}
+
+	ShotTraceStarts.Init(MuzzleLocation, Directions.Num());
+	ShotTraceEnds.SetNumUninitialized(Directions.Num(), EAllowShrinking::No);
+	for (int32 Index = 0; Index < Directions.Num(); Index++)
+	{
+		ShotTraceEnds[Index] = MyCombatMath::ShotTraceEnd(MuzzleLocation, Directions[Index]);
+	}
+	OutHits.SetNum(Directions.Num(), EAllowShrinking::No);
+	MyTraceBatch::LineTraces(GetWorld(), ShotTraceStarts, ShotTraceEnds, OutHits, ECollisionChannel::ECC_Visibility, QueryParams);
+
+	if (!Rewind)
+	{
+		return;
+	}
+	for (int32 Index = 0; Index < OutHits.Num(); Index++)
+	{
+		FHitResult& BarrelHitResult = OutHits[Index];
+		FMyRewindHit RewindHit;
+		const FVector RewindTraceEnd = BarrelHitResult.bBlockingHit ? BarrelHitResult.Location : ShotTraceEnds[Index]; //World geometry still blocks
+		if (Rewind->RewindLineTrace(ClientTimeStamp, MuzzleLocation, RewindTraceEnd, this, RewindHit))
+		{
+			BarrelHitResult = FHitResult(RewindHit.Pawn, RewindHit.Pawn->GetMesh(), RewindHit.Location, RewindHit.Normal);
+			BarrelHitResult.bBlockingHit = true;
+			BarrelHitResult.Distance = RewindHit.Distance;
+			BarrelHitResult.TraceStart = MuzzleLocation;
+			BarrelHitResult.TraceEnd = ShotTraceEnds[Index];
+			BarrelHitResult.Item = RewindHit.HitboxIndex;
+		}
+	}
+}
+
+void AMyCharacter::ApplyShotDamage(TArrayView<const FHitResult> Hits, const FVector& ShotDirection, float DamagePerHit)
+{
+	//Pellets that hit the same actor are applied as one damage event
+	struct FShotVictim
+	{
+		AActor* Actor;
+		int32 FirstHitIndex;
+		int32 NumHits;
+	};
+	TArray<FShotVictim, TInlineAllocator<16>> Victims;
+	for (int32 Index = 0; Index < Hits.Num(); Index++)
+	{
+		AActor* HitActor = Hits[Index].bBlockingHit ? Hits[Index].GetActor() : nullptr;
+		if (!HitActor)
+		{
+			continue;
+		}
+		FShotVictim* Victim = Victims.FindByPredicate([HitActor](const FShotVictim& Entry) { return Entry.Actor == HitActor; });
+		if (Victim)
+		{
+			Victim->NumHits++;
+		}
+		else
+		{
+			Victims.Add({ HitActor, Index, 1 });
+		}
+	}
+
+	for (const FShotVictim& Victim : Victims)
+	{
+		MyCombatStats::AddHits(Victim.NumHits);
+		UGameplayStatics::ApplyPointDamage(Victim.Actor, DamagePerHit * Victim.NumHits, ShotDirection, Hits[Victim.FirstHitIndex], GetController(), this, UDamageType::StaticClass());
+	}
+}
+
+void AMyCharacter::FirePellets()
+{
+	SHOOTER_COMBAT_SCOPE(STAT_ShooterFirePellets);
+	FVector MuzzleLocation;
+	if (!EquippedWeapon || !SocketCache.GetSocketLocation(GetMesh(), "gunMuzzleSocket", MuzzleLocation))
+	{
+		return;
+	}
+
+	//Aim through the crosshair like a single shot, the pellets spread around that direction
+	FHitResult CrosshairHitResult;
+	FVector CrosshairTarget;
+	TraceFromCrosshair(CrosshairHitResult, CrosshairTarget);
+	const FVector AimDirection = (CrosshairTarget - MuzzleLocation).GetSafeNormal();
+
+	const uint8 ShotSequence = NextShotSequence; //Consumed by QueueFireShot
+	const uint8 PatternIndex = AdvanceShotPattern(0.f);
+	QueueFireShot(MuzzleLocation, AimDirection, PatternIndex); //On authority this resolves the pellets into ShotHits right away
+
+	if (!bCosmeticsEnabled)
+	{
+		return;
+	}
+	if (!HasAuthority())
+	{
+		//The server applies damage, locally the pellets are only traced for their impacts
+		EquippedWeapon->GetPelletDirections(EquippedWeapon->ApplySpread(AimDirection, PatternIndex), ShotSequence, ShotDirections);
+		FCollisionQueryParams QueryParams;
+		QueryParams.AddIgnoredActor(this);
+		QueryParams.bReturnPhysicalMaterial = WantsImpactSurface();
+		ShotTraceStarts.Init(MuzzleLocation, ShotDirections.Num());
+		ShotTraceEnds.SetNumUninitialized(ShotDirections.Num(), EAllowShrinking::No);
+		for (int32 Index = 0; Index < ShotDirections.Num(); Index++)
+		{
+			ShotTraceEnds[Index] = MyCombatMath::ShotTraceEnd(MuzzleLocation, ShotDirections[Index]);
+		}
+		ShotHits.SetNum(ShotDirections.Num(), EAllowShrinking::No);
+		MyTraceBatch::LineTraces(GetWorld(), ShotTraceStarts, ShotTraceEnds, ShotHits, ECollisionChannel::ECC_Visibility, QueryParams);
+	}
+	SpawnPelletImpactFX(MuzzleLocation, AimDirection, ShotHits);
+}
+
+void AMyCharacter::SpawnPelletImpactFX(const FVector& MuzzleLocation, const FVector& AimDirection, TArrayView<const FHitResult> Hits)
+{
+	if (PistolMuzzleFX)
+	{
+		SpawnCombatEmitter(PistolMuzzleFX, MuzzleLocation, AimDirection.Rotation());
+	}
+	if (PistolBeamFX)
+	{
+		SpawnCombatEmitter(PistolBeamFX, MuzzleLocation, AimDirection.Rotation()); //One beam for the whole spread
+	}
+	if (!PistolHitFX && !ImpactEffects)
+	{
+		return;
+	}
+
+	//One impact per surface that got hit, at the average pellet location
+	struct FImpactSurface
+	{
+		const UPrimitiveComponent* Component;
+		EPhysicalSurface SurfaceType;
+		FVector LocationSum;
+		FVector NormalSum;
+		int32 NumHits;
+	};
+	TArray<FImpactSurface, TInlineAllocator<16>> Surfaces;
+	for (const FHitResult& Hit : Hits)
+	{
+		if (!Hit.bBlockingHit)
+		{
+			continue;
+		}
+		const UPrimitiveComponent* HitComponent = Hit.GetComponent();
+		FImpactSurface* Surface = Surfaces.FindByPredicate([HitComponent](const FImpactSurface& Entry) { return Entry.Component == HitComponent; });
+		if (Surface)
+		{
+			Surface->LocationSum += Hit.ImpactPoint;
+			Surface->NormalSum += Hit.ImpactNormal;
+			Surface->NumHits++;
+		}
+		else
+		{
+			Surfaces.Add({ HitComponent, UPhysicalMaterial::DetermineSurfaceType(Hit.PhysMaterial.Get()), Hit.ImpactPoint, Hit.ImpactNormal, 1 });
+		}
+	}
+
+	for (const FImpactSurface& Surface : Surfaces)
+	{
+		SpawnImpactEffect(Surface.LocationSum / Surface.NumHits, Surface.NormalSum.GetSafeNormal(), Surface.SurfaceType);
+	}
+}
+
+void AMyCharacter::TracePenetratingShot(const FVector& MuzzleLocation, const FVector& Direction, float ClientTimeStamp, bool bAuthoritative)
+{
+	SHOOTER_COMBAT_SCOPE(STAT_ShooterPenetratingShot);
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	const FVector TraceEnd = MyCombatMath::ShotTraceEnd(MuzzleLocation, Direction);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(MyPenetratingShot));
+	QueryParams.AddIgnoredActor(this);
+	QueryParams.bReturnPhysicalMaterial = true; //Surface type decides the penetration cost
+	UMyHitboxRewindSubsystem* Rewind = bAuthoritative ? GetWorld()->GetSubsystem<UMyHitboxRewindSubsystem>() : nullptr;
+	if (Rewind)
+	{
+		Rewind->AddIgnoredPawns(QueryParams);
+	}
+
+	//Blocks are downgraded to overlaps so the trace doesn't stop at the first surface. Hits come back sorted near to far.
+	const FCollisionResponseParams ResponseParams(ECollisionResponse::ECR_Overlap);
+	const int32 CapacityBeforeTrace = PenetrationHits.Max();
+	GetWorld()->LineTraceMultiByChannel(PenetrationHits, MuzzleLocation, TraceEnd, ECollisionChannel::ECC_Visibility, QueryParams, ResponseParams);
+	MyCombatStats::AddTraces(1);
+	PenetrationTraceHighWater = FMath::Max(PenetrationTraceHighWater, PenetrationHits.Num());
+	PenetrationHitsGrowths += PenetrationHits.Max() > CapacityBeforeTrace ? 1 : 0;
+
+	//Only keep what really blocks bullets, overlap volumes (pickup spheres, triggers) came back too
+	PenetrationHits.RemoveAll([](const FHitResult& Hit)
+	{
+		const UPrimitiveComponent* HitComponent = Hit.GetComponent();
+		return !HitComponent || HitComponent->GetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility) != ECollisionResponse::ECR_Block;
+	});
+
+	if (Rewind)
+	{
+		//Pawns are hit where they were when the client fired. Walk the ray one pawn at a time and merge them in.
+		FVector RewindStart = MuzzleLocation;
+		const AMyCharacter* IgnorePawn = this;
+		FMyRewindHit RewindHit;
+		while (PenetrationHits.Num() < MaxPenetrationHits && Rewind->RewindLineTrace(ClientTimeStamp, RewindStart, TraceEnd, IgnorePawn, RewindHit))
+		{
+			FHitResult& PawnHit = PenetrationHits.Emplace_GetRef(RewindHit.Pawn, RewindHit.Pawn->GetMesh(), RewindHit.Location, RewindHit.Normal);
+			PawnHit.bBlockingHit = true;
+			PawnHit.Distance = FVector::Dist(MuzzleLocation, RewindHit.Location);
+			PawnHit.TraceStart = MuzzleLocation;
+			PawnHit.TraceEnd = TraceEnd;
+			PawnHit.Item = RewindHit.HitboxIndex;
+			RewindStart = RewindHit.Location;
+			IgnorePawn = RewindHit.Pawn;
+		}
+		PenetrationHits.Sort([](const FHitResult& A, const FHitResult& B) { return A.Distance < B.Distance; });
+	}
+	if (PenetrationHits.Num() > MaxPenetrationHits)
+	{
+		PenetrationHits.SetNum(MaxPenetrationHits, EAllowShrinking::No);
+	}
+
+	//One pass near to far: damage with falloff, spend the budget, stop in the surface that overdraws it
+	float Budget = EquippedWeapon->GetPenetrationBudget();
+	float DamageScale = 1.f;
+	const AActor* LastDamagedActor = nullptr;
+	NumPenetrationHitsResolved = 0;
+	for (const FHitResult& Hit : PenetrationHits)
+	{
+		NumPenetrationHitsResolved++;
+		AActor* HitActor = Hit.GetActor();
+		if (bAuthoritative && HitActor && HitActor != LastDamagedActor) //Several components of one actor in a row take damage once
+		{
+			UGameplayStatics::ApplyPointDamage(HitActor, PistolDamage * DamageScale, Direction, Hit, GetController(), this, UDamageType::StaticClass());
+			LastDamagedActor = HitActor;
+		}
+		Budget -= EquippedWeapon->GetPenetrationCost(UPhysicalMaterial::DetermineSurfaceType(Hit.PhysMaterial.Get()));
+		if (Budget < 0.f)
+		{
+			break;
+		}
+		DamageScale *= EquippedWeapon->GetPenetrationDamageScale();
+	}
+
+	const int32 Bucket = FMath::Min(NumPenetrationHitsResolved, MaxPenetrationHits - 1);
+	PenetrationCycles[Bucket] += FPlatformTime::Cycles64() - StartCycles;
+	PenetrationShots[Bucket]++;
+}
+
+void AMyCharacter::FirePenetrating()
+{
+	FVector MuzzleLocation;
+	if (!EquippedWeapon || !SocketCache.GetSocketLocation(GetMesh(), "gunMuzzleSocket", MuzzleLocation))
+	{
+		return;
+	}
+
+	FHitResult CrosshairHitResult;
+	FVector CrosshairTarget;
+	TraceFromCrosshair(CrosshairHitResult, CrosshairTarget);
+	const FVector AimDirection = (CrosshairTarget - MuzzleLocation).GetSafeNormal();
+
+	const uint8 PatternIndex = AdvanceShotPattern(0.f);
+	const FVector SpreadDirection = EquippedWeapon->ApplySpread(AimDirection, PatternIndex);
+
+	NumPenetrationHitsResolved = 0;
+	QueueFireShot(MuzzleLocation, AimDirection, PatternIndex); //On authority this resolves the shot into PenetrationHits right away
+
+	if (!bCosmeticsEnabled)
+	{
+		return;
+	}
+	if (!HasAuthority())
+	{
+		TracePenetratingShot(MuzzleLocation, SpreadDirection, 0.f, false); //Impacts only, the server applies damage
+	}
+
+	if (PistolMuzzleFX)
+	{
+		SpawnCombatEmitter(PistolMuzzleFX, MuzzleLocation, AimDirection.Rotation());
+	}
+	if (PistolBeamFX)
+	{
+		SpawnCombatEmitter(PistolBeamFX, MuzzleLocation, SpreadDirection.Rotation());
+	}
+	for (int32 Index = 0; Index < NumPenetrationHitsResolved; Index++)
+	{
+		const FHitResult& Hit = PenetrationHits[Index];
+		SpawnImpactEffect(Hit.ImpactPoint, Hit.ImpactNormal, UPhysicalMaterial::DetermineSurfaceType(Hit.PhysMaterial.Get()));
+	}
+}
+
+void AMyCharacter::FireBallistic()
+{
+	FVector MuzzleLocation;
+	if (!EquippedWeapon || !SocketCache.GetSocketLocation(GetMesh(), "gunMuzzleSocket", MuzzleLocation))
+	{
+		return;
+	}
+
+	FHitResult CrosshairHitResult;
+	FVector CrosshairTarget;
+	TraceFromCrosshair(CrosshairHitResult, CrosshairTarget);
+	const FVector AimDirection = (CrosshairTarget - MuzzleLocation).GetSafeNormal();
+
+	const uint8 PatternIndex = AdvanceShotPattern(0.f);
+	QueueFireShot(MuzzleLocation, AimDirection, PatternIndex); //On authority this launches the real bullet
+
+	if (!bCosmeticsEnabled)
+	{
+		return;
+	}
+	if (!HasAuthority())
+	{
+		//Local copy of the server's bullet, only for the impact FX
+		if (UMyBallisticsSubsystem* Ballistics = GetWorld()->GetSubsystem<UMyBallisticsSubsystem>())
+		{
+			Ballistics->LaunchBullet(MuzzleLocation, EquippedWeapon->ApplySpread(AimDirection, PatternIndex) * EquippedWeapon->GetMuzzleVelocity(), this, EquippedWeapon->GetBulletLifetime(), EquippedWeapon->GetBulletGravityScale());
+		}
+	}
+	if (PistolMuzzleFX)
+	{
+		SpawnCombatEmitter(PistolMuzzleFX, MuzzleLocation, AimDirection.Rotation());
+	}
+}
+
+void AMyCharacter::OnBulletImpact(const FMyBulletImpact& Impact)
+{
+	if (Impact.Instigator.Get() != this)
+	{
+		return; //Someone else's bullet
+	}
+
+	if (bCosmeticsEnabled)
+	{
+		SpawnImpactEffect(Impact.Hit.ImpactPoint, Impact.Hit.ImpactNormal, UPhysicalMaterial::DetermineSurfaceType(Impact.Hit.PhysMaterial.Get()));
+	}
+	if (HasAuthority() && Impact.Hit.GetActor())
+	{
+		UGameplayStatics::ApplyPointDamage(Impact.Hit.GetActor(), PistolDamage, Impact.Velocity.GetSafeNormal(), Impact.Hit, GetController(), this, UDamageType::StaticClass());
+	}
+}
+
+void AMyCharacter::UpdateAutomaticFire(float DeltaTime)
+{
+	FVector MuzzleLocation;
+	if (!EquippedWeapon || !EquippedWeapon->IsAutomatic() || !SocketCache.GetSocketLocation(GetMesh(), "gunMuzzleSocket", MuzzleLocation))
+	{
+		FireScheduler.Stop();
+		bHasPreviousMuzzle = false;
+		return;
+	}
+	const FVector AimDirection = GetAimRay().Direction;
+
+	FireScheduler.SetInterval(EquippedWeapon->GetShotInterval());
+	if (FireScheduler.Advance(DeltaTime, DueShotAlphas) > 0)
+	{
+		if (!bHasPreviousMuzzle)
+		{
+			PreviousMuzzleLocation = MuzzleLocation;
+			PreviousAimDirection = AimDirection;
+		}
+		FireAutomaticShots(DeltaTime, MuzzleLocation, AimDirection);
+		PlayAnimation(PistolFireMontage, "Fire"); //Once per frame however many shots went out
+		PlaySound(PistolSoundCue, GetWeaponSoundGroup());
+	}
+
+	PreviousMuzzleLocation = MuzzleLocation;
+	PreviousAimDirection = AimDirection;
+	bHasPreviousMuzzle = true;
+}
+
+void AMyCharacter::FireAutomaticShots(float DeltaTime, const FVector& MuzzleLocation, const FVector& AimDirection)
+{
+	SHOOTER_COMBAT_SCOPE(STAT_ShooterAutomaticShots);
+	//Barrels converge on the crosshair target of this frame; earlier shots are turned back by how far the aim moved since
+	FHitResult CrosshairHitResult;
+	FVector CrosshairTarget;
+	TraceFromCrosshair(CrosshairHitResult, CrosshairTarget);
+	const FQuat AimSinceShot = FQuat::FindBetweenNormals(AimDirection, PreviousAimDirection);
+
+	const int32 NumShots = DueShotAlphas.Num();
+	AutoFireStarts.SetNumUninitialized(NumShots, EAllowShrinking::No);
+	AutoFireDirections.SetNumUninitialized(NumShots, EAllowShrinking::No);
+	for (int32 Shot = 0; Shot < NumShots; Shot++)
+	{
+		const float Alpha = DueShotAlphas[Shot];
+		const FVector ShotMuzzle = FMath::Lerp(PreviousMuzzleLocation, MuzzleLocation, Alpha);
+		const FQuat ShotAimOffset = FQuat::Slerp(FQuat::Identity, AimSinceShot, 1.f - Alpha);
+		AutoFireStarts[Shot] = ShotMuzzle;
+		AutoFireDirections[Shot] = ShotAimOffset.RotateVector((CrosshairTarget - ShotMuzzle).GetSafeNormal());
+	}
+
+	//Every fire mode walks the recoil and spread pattern
+	AutoFirePatternIndices.SetNumUninitialized(NumShots, EAllowShrinking::No);
+	for (int32 Shot = 0; Shot < NumShots; Shot++)
+	{
+		AutoFirePatternIndices[Shot] = AdvanceShotPattern((1.f - DueShotAlphas[Shot]) * DeltaTime);
+	}
+
+	switch (EquippedWeapon->GetFireMode())
+	{
+	case EWeaponFireMode::EWFM_PelletSpread:
+		FireAutomaticPellets(DeltaTime, MuzzleLocation, AimDirection);
+		return;
+	case EWeaponFireMode::EWFM_Penetrating:
+		FireAutomaticPenetrating(DeltaTime, MuzzleLocation, AimDirection);
+		return;
+	case EWeaponFireMode::EWFM_Ballistic:
+		FireAutomaticBallistic(DeltaTime, MuzzleLocation, AimDirection);
+		return;
+	default:
+		break;
+	}
+
+	AutoFireEnds.SetNumUninitialized(NumShots, EAllowShrinking::No);
+	for (int32 Shot = 0; Shot < NumShots; Shot++)
+	{
+		AutoFireEnds[Shot] = MyCombatMath::ShotTraceEnd(AutoFireStarts[Shot], EquippedWeapon->ApplySpread(AutoFireDirections[Shot], AutoFirePatternIndices[Shot]));
+	}
+
+	if (bCosmeticsEnabled)
+	{
+		FCollisionQueryParams QueryParams;
+		QueryParams.AddIgnoredActor(this);
+		QueryParams.bReturnPhysicalMaterial = WantsImpactSurface();
+		AutoFireHits.SetNum(NumShots, EAllowShrinking::No);
+		MyTraceBatch::LineTraces(GetWorld(), AutoFireStarts, AutoFireEnds, AutoFireHits, ECollisionChannel::ECC_Visibility, QueryParams);
+
+		if (PistolMuzzleFX)
+		{
+			SpawnCombatEmitter(PistolMuzzleFX, MuzzleLocation, AimDirection.Rotation()); //One flash per frame
+		}
+		for (int32 Shot = 0; Shot < NumShots; Shot++)
+		{
+			const FHitResult& Hit = AutoFireHits[Shot];
+			if (PistolBeamFX)
+			{
+				SpawnCombatEmitter(PistolBeamFX, AutoFireStarts[Shot], AutoFireDirections[Shot].Rotation());
+			}
+			if (Hit.bBlockingHit)
+			{
+				SpawnImpactEffect(Hit.ImpactPoint, Hit.ImpactNormal, UPhysicalMaterial::DetermineSurfaceType(Hit.PhysMaterial.Get()));
+			}
+		}
+	}
+
+	//Each shot carries the time it was really due, so the server rewinds to the right moment
+	for (int32 Shot = 0; Shot < NumShots; Shot++)
+	{
+		QueueFireShot(AutoFireStarts[Shot], AutoFireDirections[Shot], AutoFirePatternIndices[Shot], (1.f - DueShotAlphas[Shot]) * DeltaTime);
+	}
+}
+
+void AMyCharacter::FireAutomaticPellets(float DeltaTime, const FVector& MuzzleLocation, const FVector& AimDirection)
+{
+	//Every pellet of every shot this frame goes out in one trace batch, impacts merge per surface across the shots
+	const bool bTraceLocally = bCosmeticsEnabled && !HasAuthority();
+	AutoFireHits.Reset();
+	ShotTraceStarts.Reset();
+	ShotTraceEnds.Reset();
+	for (int32 Shot = 0; Shot < DueShotAlphas.Num(); Shot++)
+	{
+		const uint8 ShotSequence = NextShotSequence; //Consumed by QueueFireShot
+		QueueFireShot(AutoFireStarts[Shot], AutoFireDirections[Shot], AutoFirePatternIndices[Shot], (1.f - DueShotAlphas[Shot]) * DeltaTime);
+		if (bTraceLocally)
+		{
+			EquippedWeapon->GetPelletDirections(EquippedWeapon->ApplySpread(AutoFireDirections[Shot], AutoFirePatternIndices[Shot]), ShotSequence, ShotDirections);
+			for (const FVector& Direction : ShotDirections)
+			{
+				ShotTraceStarts.Add(AutoFireStarts[Shot]);
+				ShotTraceEnds.Add(MyCombatMath::ShotTraceEnd(AutoFireStarts[Shot], Direction));
+			}
+		}
+		else if (bCosmeticsEnabled)
+		{
+			AutoFireHits.Append(ShotHits); //On authority QueueFireShot already resolved the pellets
+		}
+	}
+
+	if (!bCosmeticsEnabled)
+	{
+		return;
+	}
+	if (bTraceLocally)
+	{
+		FCollisionQueryParams QueryParams;
+		QueryParams.AddIgnoredActor(this);
+		QueryParams.bReturnPhysicalMaterial = WantsImpactSurface();
+		AutoFireHits.SetNum(ShotTraceStarts.Num(), EAllowShrinking::No);
+		MyTraceBatch::LineTraces(GetWorld(), ShotTraceStarts, ShotTraceEnds, AutoFireHits, ECollisionChannel::ECC_Visibility, QueryParams);
+	}
+	SpawnPelletImpactFX(MuzzleLocation, AimDirection, AutoFireHits);
+}
+
+void AMyCharacter::FireAutomaticPenetrating(float DeltaTime, const FVector& MuzzleLocation, const FVector& AimDirection)
+{
+	//Each shot needs its own multi trace, but the FX for all of them go out together
+	AutoFireHits.Reset();
+	for (int32 Shot = 0; Shot < DueShotAlphas.Num(); Shot++)
+	{
+		NumPenetrationHitsResolved = 0;
+		QueueFireShot(AutoFireStarts[Shot], AutoFireDirections[Shot], AutoFirePatternIndices[Shot], (1.f - DueShotAlphas[Shot]) * DeltaTime);
+		if (!bCosmeticsEnabled)
+		{
+			continue;
+		}
+		if (!HasAuthority())
+		{
+			TracePenetratingShot(AutoFireStarts[Shot], EquippedWeapon->ApplySpread(AutoFireDirections[Shot], AutoFirePatternIndices[Shot]), 0.f, false); //Impacts only, the server applies damage
+		}
+		AutoFireHits.Append(PenetrationHits.GetData(), NumPenetrationHitsResolved);
+	}
+
+	if (!bCosmeticsEnabled)
+	{
+		return;
+	}
+	if (PistolMuzzleFX)
+	{
+		SpawnCombatEmitter(PistolMuzzleFX, MuzzleLocation, AimDirection.Rotation()); //One flash per frame
+	}
+	for (int32 Shot = 0; Shot < DueShotAlphas.Num() && PistolBeamFX; Shot++)
+	{
+		SpawnCombatEmitter(PistolBeamFX, AutoFireStarts[Shot], EquippedWeapon->ApplySpread(AutoFireDirections[Shot], AutoFirePatternIndices[Shot]).Rotation());
+	}
+	for (const FHitResult& Hit : AutoFireHits)
+	{
+		SpawnImpactEffect(Hit.ImpactPoint, Hit.ImpactNormal, UPhysicalMaterial::DetermineSurfaceType(Hit.PhysMaterial.Get()));
+	}
+}
+
+void AMyCharacter::FireAutomaticBallistic(float DeltaTime, const FVector& MuzzleLocation, const FVector& AimDirection)
+{
+	//Bullets already fly as one batch in the ballistics subsystem, only the launch and the flash are per frame here
+	UMyBallisticsSubsystem* Ballistics = bCosmeticsEnabled && !HasAuthority() ? GetWorld()->GetSubsystem<UMyBallisticsSubsystem>() : nullptr;
+	for (int32 Shot = 0; Shot < DueShotAlphas.Num(); Shot++)
+	{
+		QueueFireShot(AutoFireStarts[Shot], AutoFireDirections[Shot], AutoFirePatternIndices[Shot], (1.f - DueShotAlphas[Shot]) * DeltaTime);
+		if (Ballistics)
+		{
+			//Local copy of the server's bullet, only for the impact FX
+			Ballistics->LaunchBullet(AutoFireStarts[Shot], EquippedWeapon->ApplySpread(AutoFireDirections[Shot], AutoFirePatternIndices[Shot]) * EquippedWeapon->GetMuzzleVelocity(), this, EquippedWeapon->GetBulletLifetime(), EquippedWeapon->GetBulletGravityScale());
+		}
+	}
+	if (bCosmeticsEnabled && PistolMuzzleFX)
+	{
+		SpawnCombatEmitter(PistolMuzzleFX, MuzzleLocation, AimDirection.Rotation()); //One flash per frame
+	}
+}
+
+uint8 AMyCharacter::AdvanceShotPattern(float TimeBeforeNow)
+{
+	if (!EquippedWeapon)
+	{
+		return 0;
+	}
+	const float ShotTime = GetFireTimeStamp() - TimeBeforeNow; //Exactly the stamp QueueFireShot sends, so the server lands on the same index
+	const int32 PatternIndex = EquippedWeapon->GetPatternIndex(PatternShotCount, ShotTime - LastPatternShotTime);
+	PatternShotCount = PatternIndex + 1;
+	LastPatternShotTime = ShotTime;
+
+	if (bCosmeticsEnabled && IsLocallyControlled())
+	{
+		RecoilKick += EquippedWeapon->GetRecoil(PatternIndex); //Picked up by CameraInterp, and through the camera by the aim ray
+	}
+	return static_cast<uint8>(PatternIndex);
+}
+
+bool AMyCharacter::WantsImpactSurface() const
+{
+	return ImpactEffects && ImpactEffects->NeedsPhysicalMaterial(); //Physical materials cost extra per hit, only ask when the table has per surface entries
+}
+
+void AMyCharacter::SpawnImpactEffect(const FVector& Location, const FVector& Normal, EPhysicalSurface Surface)
+{
+	if (!ImpactEffects)
+	{
+		if (PistolHitFX)
+		{
+			SpawnCombatEmitter(PistolHitFX, Location, Normal.Rotation());
+		}
+		return;
+	}
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	const FMyImpactEffect& Effect = ImpactEffects->GetImpactEffect(Surface);
+	ImpactLookupCycles += FPlatformTime::Cycles64() - StartCycles;
+	ImpactLookups++;
+
+	if (Effect.ImpactFX)
+	{
+		SpawnCombatEmitter(Effect.ImpactFX, Location, Normal.Rotation());
+	}
+	if (UMyCombatAudioSubsystem* CombatAudio = Effect.ImpactSound ? GetWorld()->GetSubsystem<UMyCombatAudioSubsystem>() : nullptr)
+	{
+		CombatAudio->PlayCombatSound(Effect.ImpactSound, Location, EMyCombatSoundGroup::ECSG_Impact);
+	}
+	if (Effect.DecalMaterial)
+	{
+		if (UMyDecalPoolSubsystem* DecalPool = GetWorld()->GetSubsystem<UMyDecalPoolSubsystem>())
+		{
+			DecalPool->PlaceDecal(Effect.DecalMaterial, Effect.DecalSize, Location, Normal);
+		}
+	}
+}
+
+UParticleSystemComponent* AMyCharacter::SpawnCombatEmitter(UParticleSystem* ParticleFX, const FTransform& Transform)
+{
+	if (UMyCombatFXSubsystem* CombatFX = GetWorld()->GetSubsystem<UMyCombatFXSubsystem>())
+	{
+		return CombatFX->SpawnEmitter(ParticleFX, Transform); //Counts pool misses per world
+	}
+	LLM_SCOPE_BYTAG(Shooter_CombatFX);
+	MyCombatStats::AddEmitterSpawned();
+	return UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ParticleFX, Transform, true, EPSCPoolMethod::AutoRelease);
+}
@@ -4,8 +4,57 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "MyFireTypes.h"
+#include "MyMontagePlayer.h"
+#include "MySocketHandleCache.h"
 #include "MyCharacter.generated.h"
 
+struct FMyBotInput;
+enum class EMyCombatSoundGroup : uint8;
+
+//Ray through the crosshair, in world space
+struct FMyAimRay
+{
+	FVector Origin = FVector::ZeroVector;
+	FVector Direction = FVector::ForwardVector;
+};
+
+//Everything UMyAnimInstance reads from its character, gathered once per frame right after movement
+struct FMyAnimInputs
+{
+	float Speed = 0.f; //Ground speed
+	float StrafeValue = 0.f; //Movement yaw relative to aim yaw
+	bool bIsAccelerating = false;
+	bool bIsMoving = false;
+	bool bIsAiming = false;
+};
+
+enum class EMyCharacterTickWork : uint8
+{
+	ECTW_Camera,
+	ECTW_Focus,
+	ECTW_AnimInputs
+};
+
+//Character work that runs outside the main actor tick, in its own tick group with its own prerequisites
+USTRUCT()
+struct FMyCharacterTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	class AMyCharacter* Character = nullptr;
+	EMyCharacterTickWork Work = EMyCharacterTickWork::ECTW_Camera;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FMyCharacterTickFunction> : public TStructOpsTypeTraitsBase2<FMyCharacterTickFunction>
+{
+	enum { WithCopy = false };
+};
+
 UCLASS()
 
 class UE5POINT5_SHOOTER_API AMyCharacter : public ACharacter
@@ -17,6 +66,10 @@ public:
 	AMyCharacter();
 	virtual void Tick(float DeltaTime) override;
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void RegisterActorTickFunctions(bool bRegister) override;
+	void ApplyBotInput(const FMyBotInput& Input, float DeltaTime); //Drives the character like a player would, used by AI bots
+	bool PickupItem(class AMyItem* Item);
 
 
 protected:
@@ -26,19 +79,68 @@ protected:
 	void MoveRight(float Value);
 	void TurnAtRate(float Rate);
 	void LookUpAtRate(float Rate);
+	void FireButtonPressed();
+	void FireButtonReleased();
 	void FirePistol();
+	void UltimateFire();
 	void AimingPressed();
 	void AimingReleased();
 	void CameraInterp(float DeltaTime);
 	void SpawnFX(FName SocketName, UParticleSystem* ParticleFX);
 	void SpawnBeamFX(FVector Start, FVector End);
 	void PlayAnimation(UAnimMontage* AnimationMontage, FName SectionName);
-	void PlaySound(USoundBase* SoundCue);
-	bool GetBeamEndPointLocation(const FVector& SocketLocation, FVector& BeamEndLocation);
+	void PlaySound(USoundBase* SoundCue, EMyCombatSoundGroup Group);
+	EMyCombatSoundGroup GetWeaponSoundGroup() const;
+	void ApplyForceWhenUltimateIsUsed(float Total_Force, float Upward_Force);
+	void DelayedUltimateAbility();
+	void DelayedUltimateAbilityEmitter();
+	void LaunchUltimateRocket();
+	void OnProjectileImpact(const struct FMyProjectileImpact& Impact);
+	void EnablePlayerInput();
+	bool GetBeamEndPointLocation(const FVector& SocketLocation, uint8 PatternIndex, FVector& AimDirection, FVector& BeamEndLocation, FHitResult& BarrelHitResult);
+	void SpawnImpactEffect(const FVector& Location, const FVector& Normal, EPhysicalSurface Surface);
+	bool WantsImpactSurface() const;
+	class UParticleSystemComponent* SpawnCombatEmitter(UParticleSystem* ParticleFX, const FTransform& Transform);
+	FORCEINLINE class UParticleSystemComponent* SpawnCombatEmitter(UParticleSystem* ParticleFX, const FVector& Location, const FRotator& Rotation) { return SpawnCombatEmitter(ParticleFX, FTransform(Rotation, Location)); }
 	bool TraceFromCrosshair(FHitResult& HitResult, FVector& HitLocation);
+	void UpdateAimRay();
 	void TraceItems();
 	class AMyWeapon* DefaultWeaponSpawn();
 	void EquipWeapon(AMyWeapon* WeaponToEquip);
+	void DropWeapon();
+	void SelectButtonPressed();
+	AMyItem* FindPickupCandidate() const;
+
+	//Networked fire
+	void QueueFireShot(const FVector& MuzzleLocation, const FVector& ShotDirection, uint8 PatternIndex, float TimeBeforeNow = 0.f);
+	uint8 AdvanceShotPattern(float TimeBeforeNow);
+	float GetFireTimeStamp() const; //Server world time as this machine sees it, what shots are stamped with
+	void FlushFireShots();
+	UFUNCTION(Server, Reliable)
+	void ServerFireShots(const TArray<FMyFireShot>& Shots);
+	void ProcessFireShot(const FMyFireShot& Shot);
+	bool ValidateFireShot(const FMyFireShot& Shot);
+	void ServerTraceShot(const FVector& MuzzleLocation, float ClientTimeStamp, TArrayView<const FVector> Directions, TArray<FHitResult>& OutHits);
+	void ApplyShotDamage(TArrayView<const FHitResult> Hits, const FVector& ShotDirection, float DamagePerHit);
+
+	//Pellet spread fire
+	void FirePellets();
+	void SpawnPelletImpactFX(const FVector& MuzzleLocation, const FVector& AimDirection, TArrayView<const FHitResult> Hits);
+
+	//Penetrating fire
+	void FirePenetrating();
+	void TracePenetratingShot(const FVector& MuzzleLocation, const FVector& Direction, float ClientTimeStamp, bool bAuthoritative);
+
+	//Ballistic fire
+	void FireBallistic();
+	void OnBulletImpact(const struct FMyBulletImpact& Impact);
+
+	//Automatic fire
+	void UpdateAutomaticFire(float DeltaTime);
+	void FireAutomaticShots(float DeltaTime, const FVector& MuzzleLocation, const FVector& AimDirection);
+	void FireAutomaticPellets(float DeltaTime, const FVector& MuzzleLocation, const FVector& AimDirection);
+	void FireAutomaticPenetrating(float DeltaTime, const FVector& MuzzleLocation, const FVector& AimDirection);
+	void FireAutomaticBallistic(float DeltaTime, const FVector& MuzzleLocation, const FVector& AimDirection);
 
 private:
 	//Camera boom positioning the camera behind the character
@@ -65,10 +167,49 @@ private:
 	class UParticleSystem* PistolHitFX;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	class UParticleSystem* PistolBeamFX;
+	//Impact FX, sound and decal per surface. PistolHitFX is used when not set.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	class UMyImpactEffectsAsset* ImpactEffects;
+	FMyMontagePlayer MontagePlayer; //Fire and ultimate montages
+	FMySocketHandleCache SocketCache; //Muzzle sockets for FX, traces, shot validation and rockets
+	uint64 ImpactLookupCycles; //Logged in EndPlay
+	int64 ImpactLookups;
 	//Primary Fire Anim Montage
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	class UAnimMontage* PistolFireMontage;
 
+	//Sound Cue - Ultimate
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	class USoundCue* UltimateSoundCue;
+	//Muzzle Ultimate Flash
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	class UParticleSystem* UltimateMuzzleFX;
+	//Ultimate Anim Montage
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	class UAnimMontage* UltimateFireMontage;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Ultimate, meta = (AllowPrivateAccess = "true"))
+	float UltimateForceMagnitude;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Ultimate, meta = (AllowPrivateAccess = "true"))
+	float UltimateUpwardForce;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Ultimate, meta = (AllowPrivateAccess = "true"))
+	float UltimateAbilityDelay;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Ultimate, meta = (AllowPrivateAccess = "true"))
+	float UltimateAbilityEmitterDelay;
+	//Ultimate Rocket
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Ultimate, meta = (AllowPrivateAccess = "true"))
+	class UParticleSystem* UltimateImpactFX;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Ultimate, meta = (AllowPrivateAccess = "true"))
+	float UltimateRocketSpeed;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Ultimate, meta = (AllowPrivateAccess = "true"))
+	float UltimateRocketGravityScale;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Ultimate, meta = (AllowPrivateAccess = "true"))
+	float UltimateRocketRadius;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Ultimate, meta = (AllowPrivateAccess = "true"))
+	float UltimateRocketLifetime;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Ultimate, meta = (AllowPrivateAccess = "true"))
+	float UltimateDamage;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Ultimate, meta = (AllowPrivateAccess = "true"))
+	float UltimateDamageRadius;
 
 	//Camera Zoom Variables
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
@@ -79,8 +220,26 @@ private:
 	float ZoomInterpSpeed;
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	bool bIsAiming;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Camera, meta = (AllowPrivateAccess = "true"))
+	FVector2D CrosshairOffset; //Degrees (yaw, pitch) the crosshair sits away from the screen center
+
+	FMyAimRay CachedAimRay;
+	uint64 AimRayFrame; //GFrameCounter when CachedAimRay was computed
 
 	bool bTraceForHit;
+	bool bCosmeticsEnabled; //False on a dedicated server
+	uint64 TickCycles; //Tick cost accounting, logged in EndPlay
+	int32 NumTicks;
+
+	//Split out of Tick, see RegisterActorTickFunctions for the order they run in
+	FMyCharacterTickFunction CameraTick;
+	FMyCharacterTickFunction FocusTick;
+	FMyCharacterTickFunction AnimInputTick;
+	FMyAnimInputs AnimInputs;
+	void TickCamera(float DeltaTime);
+	void TickFocus(float DeltaTime);
+	void GatherAnimInputs(float DeltaTime);
+	friend struct FMyCharacterTickFunction;
 	int8 IncrementValueForItemCount;
 	class AMyItem* MyItemLastFrame;
 
@@ -91,6 +250,74 @@ private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Weapon, meta = (AllowPrivateAccess = "true"))
 	TSubclassOf<AMyWeapon> BaseWeaponClass; //TSubclassOf<AWeapon> allows you to use the AWeapon class or any of its child classes in Blueprints.
 
+	//Networked Fire Variables
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float PistolDamage;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Network, meta = (AllowPrivateAccess = "true"))
+	float MaxMuzzleErrorDistance; //How far the claimed muzzle may be from the server's muzzle socket
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Network, meta = (AllowPrivateAccess = "true"))
+	float MaxShotAngleError; //Degrees between the claimed direction and the server's aim rotation
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Network, meta = (AllowPrivateAccess = "true"))
+	float MaxShotTimeError; //Seconds a claimed timestamp may be in the past or the future
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Network, meta = (AllowPrivateAccess = "true"))
+	TArray<FMyHitboxDefinition> RewindHitboxes; //Boxes kept in the server's lag compensation history, empty uses the capsule
+
+	TArray<FMyFireShot> PendingFireShots; //Shots fired this tick, sent to the server as one bunch
+	//Scratch for batched shot traces, reused between shots
+	TArray<FVector> ShotDirections;
+	TArray<FVector> ShotTraceStarts;
+	TArray<FVector> ShotTraceEnds;
+	TArray<FHitResult> ShotHits;
+
+	//Every surface along a penetrating shot, sorted near to far. Reserved once, Reset between shots keeps the allocation.
+	//The multi trace can't be capped and returns overlap volumes too, so it may still grow past the reserve; EndPlay logs the peak.
+	static constexpr int32 MaxPenetrationHits = 16;
+	static constexpr int32 PenetrationTraceReserve = 64;
+	TArray<FHitResult> PenetrationHits;
+	int32 PenetrationTraceHighWater; //Most hits one multi trace returned, before filtering
+	int32 PenetrationHitsGrowths; //Times a trace outgrew the allocation
+	int32 NumPenetrationHitsResolved; //Hits up to and including the surface the shot stopped in
+	uint64 PenetrationCycles[MaxPenetrationHits]; //Trace and resolve time, by number of surfaces resolved. Logged in EndPlay.
+	int32 PenetrationShots[MaxPenetrationHits];
+
+	//Automatic fire. Shots due inside a frame are spread between last frame's muzzle/aim and this frame's.
+	FMyFireScheduler FireScheduler;
+	TArray<float, TInlineAllocator<8>> DueShotAlphas;
+	FVector PreviousMuzzleLocation;
+	FVector PreviousAimDirection;
+	bool bHasPreviousMuzzle;
+	TArray<FVector> AutoFireStarts;
+	TArray<FVector> AutoFireEnds;
+	TArray<FVector> AutoFireDirections;
+	TArray<FHitResult> AutoFireHits;
+	TArray<uint8> AutoFirePatternIndices;
+
+	//Recoil and spread pattern position, see AMyWeapon::GetPatternIndex
+	int32 PatternShotCount;
+	float LastPatternShotTime; //Fire timestamp, the server walks its copy of the pattern on the same stamps
+	int32 ServerPatternShotCount; //Server's own pattern position, from accepted shots only
+	uint8 LastServerPatternIndex; //Worked out by the server for the last accepted shot, its spread is applied with this
+	FRotator RecoilKick; //Camera kick still to recover from, CameraInterp eases the camera towards it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Camera, meta = (AllowPrivateAccess = "true"))
+	float RecoilRecoverySpeed;
+	uint8 NextShotSequence;
+	uint8 LastServerShotSequence;
+	float LastFireTimeStamp; //Stamp of the last shot this client queued, any fire mode
+
+	//Server side fire rate, from the equipped weapon's shot interval
+	float GetServerShotInterval() const;
+	int32 GetMaxShotsPerFireRPC() const;
+	float LastAcceptedShotTimeStamp; //Client timestamp of the last shot that passed validation
+	float FireShotBudget; //Shots the server will still accept, refills by one per shot interval of server time
+	double FireShotBudgetTime;
+
+	//Fire RPC accounting, logged in EndPlay
+	int32 FireShotsSent;
+	int64 FireBitsSent;
+	int32 FireShotsValidated;
+	int32 FireShotsRejected;
+	uint64 FireValidationCycles;
+
 	FTimerHandle UltimateHandle; //Used for delaying ultimate
 	FTimerHandle UltimateEmitterHandle;
 	FTimerHandle PlayerInputTimeHandle;
@@ -99,5 +326,12 @@ public:
 	FORCEINLINE USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	FORCEINLINE UCameraComponent* GetFollowCamera() const { return FollowCamera; }
 	FORCEINLINE bool ReturnIsAiming() const { return bIsAiming; }
+	FORCEINLINE bool AreCosmeticsEnabled() const { return bCosmeticsEnabled; }
+	FORCEINLINE const FMyAnimInputs& GetAnimInputs() const { return AnimInputs; }
+	const FMyAimRay& GetAimRay(); //Camera based, cached once per frame. Works for players, bots and servers alike
+	FORCEINLINE float GetBaseTurnRate() const { return BaseTurnRate; }
+	FORCEINLINE float GetBaseLookUpRate() const { return BaseLookUpRate; }
+	FORCEINLINE AMyWeapon* GetEquippedWeapon() const { return EquippedWeapon; }
+	FORCEINLINE const TArray<FMyHitboxDefinition>& GetRewindHitboxes() const { return RewindHitboxes; }
 	void IncrementOverlappedItemCount(int8 Value);
 };
@@ -0,0 +1,96 @@
+#include "MyCombatAudioSubsystem.h"
+#include "MyCombatStats.h"
+#include "Kismet/GameplayStatics.h"
+#include "Sound/SoundBase.h"
+#include "Sound/SoundConcurrency.h"
+#include "Sound/SoundAttenuation.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Play Combat Sound"), STAT_ShooterPlayCombatSound, STATGROUP_ShooterCombat);
+
+//Voices per group before the oldest one is stopped
+static constexpr int32 GroupVoiceLimits[static_cast<int32>(EMyCombatSoundGroup::ECSG_MAX)] = { 8, 6, 6, 8, 4, 12 };
+
+void UMyCombatAudioSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	LLM_SCOPE_BYTAG(Shooter_CombatAudio);
+	Super::Initialize(Collection);
+
+	for (int32 Group = 0; Group < static_cast<int32>(EMyCombatSoundGroup::ECSG_MAX); Group++)
+	{
+		USoundConcurrency* Concurrency = NewObject<USoundConcurrency>(this);
+		Concurrency->Concurrency.MaxCount = GroupVoiceLimits[Group];
+		Concurrency->Concurrency.ResolutionRule = EMaxConcurrentResolutionRule::StopOldest;
+		Concurrency->Concurrency.bLimitToOwner = false;
+		GroupConcurrency.Add(Concurrency);
+	}
+
+	DefaultAttenuation = NewObject<USoundAttenuation>(this);
+	DefaultAttenuation->Attenuation.bAttenuate = true;
+	DefaultAttenuation->Attenuation.bSpatialize = true;
+	DefaultAttenuation->Attenuation.AttenuationShapeExtents = FVector(400.f, 0.f, 0.f); //Full volume radius
+	DefaultAttenuation->Attenuation.FalloffDistance = 4000.f;
+
+	SoundsPlayed = 0;
+	SoundsCulled = 0;
+}
+
+void UMyCombatAudioSubsystem::Deinitialize()
+{
+	if (SoundsPlayed + SoundsCulled > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Combat audio: %lld sounds played, %lld culled out of range"), SoundsPlayed, SoundsCulled);
+	}
+	Super::Deinitialize();
+}
+
+bool UMyCombatAudioSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UMyCombatAudioSubsystem::IsAudibleByAnyListener(const FVector& Location, float MaxDistance) const
+{
+	const float MaxDistanceSquared = FMath::Square(MaxDistance);
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (!PlayerController || !PlayerController->IsLocalController())
+		{
+			continue;
+		}
+		FVector ListenerLocation, ListenerFront, ListenerRight;
+		PlayerController->GetAudioListenerPosition(ListenerLocation, ListenerFront, ListenerRight);
+		if (FVector::DistSquared(ListenerLocation, Location) <= MaxDistanceSquared)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool UMyCombatAudioSubsystem::PlayCombatSound(USoundBase* Sound, const FVector& Location, EMyCombatSoundGroup Group, AActor* OwningActor)
+{
+	SHOOTER_COMBAT_SCOPE(STAT_ShooterPlayCombatSound);
+	LLM_SCOPE_BYTAG(Shooter_CombatAudio);
+	if (!Sound)
+	{
+		return false;
+	}
+
+	//Assets that set their own attenuation keep it, the rest use ours so nothing plays at full volume across the map
+	USoundAttenuation* Attenuation = Sound->AttenuationSettings ? nullptr : DefaultAttenuation;
+	const float MaxDistance = Attenuation ? Attenuation->Attenuation.GetMaxDimension() : Sound->GetMaxDistance();
+	if (!IsAudibleByAnyListener(Location, MaxDistance))
+	{
+		SoundsCulled++;
+		MyCombatStats::AddSoundCulled();
+		return false;
+	}
+
+	UGameplayStatics::PlaySoundAtLocation(this, Sound, Location, FRotator::ZeroRotator, 1.f, 1.f, 0.f, Attenuation, GroupConcurrency[static_cast<int32>(Group)], OwningActor);
+	SoundsPlayed++;
+	MyCombatStats::AddSoundPlayed();
+	return true;
+}
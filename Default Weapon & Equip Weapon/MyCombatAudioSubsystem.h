@@ -0,0 +1,50 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MyCombatAudioSubsystem.generated.h"
+
+class USoundBase;
+class USoundConcurrency;
+class USoundAttenuation;
+
+//Which concurrency group a combat sound competes in
+enum class EMyCombatSoundGroup : uint8
+{
+	ECSG_SingleShot,
+	ECSG_PelletSpread,
+	ECSG_Penetrating,
+	ECSG_Ballistic,
+	ECSG_Ultimate,
+	ECSG_Impact,
+
+	ECSG_MAX
+};
+
+//All gunshots, ultimates and impacts go through here instead of PlaySound2D.
+//Sounds play spatialized at their source (with a default attenuation when the asset has none), each group has its own voice limit
+//that stops the oldest voice, and a sound no listener can hear is dropped before anything is created for it.
+UCLASS()
+class UE5POINT5_SHOOTER_API UMyCombatAudioSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	//Returns false when the sound was culled
+	bool PlayCombatSound(USoundBase* Sound, const FVector& Location, EMyCombatSoundGroup Group, AActor* OwningActor = nullptr);
+
+private:
+	bool IsAudibleByAnyListener(const FVector& Location, float MaxDistance) const;
+
+	UPROPERTY()
+	TArray<USoundConcurrency*> GroupConcurrency; //One per EMyCombatSoundGroup
+	UPROPERTY()
+	USoundAttenuation* DefaultAttenuation;
+
+	int64 SoundsPlayed;
+	int64 SoundsCulled;
+};
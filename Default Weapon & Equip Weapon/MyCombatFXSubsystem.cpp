@@ -0,0 +1,52 @@
+#include "MyCombatFXSubsystem.h"
+#include "Kismet/GameplayStatics.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "MyCombatStats.h"
+
+bool UMyCombatFXSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UMyCombatFXSubsystem::Deinitialize()
+{
+	if (Spawned > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Combat FX: %lld emitters spawned, %lld pool misses (%.1f%%)"), Spawned, Misses, 100.0 * Misses / Spawned);
+	}
+	Super::Deinitialize();
+}
+
+UParticleSystemComponent* UMyCombatFXSubsystem::SpawnEmitter(UParticleSystem* ParticleFX, const FTransform& Transform)
+{
+	LLM_SCOPE_BYTAG(Shooter_CombatFX);
+	//Pooled through the world's particle component pool, the component goes back to it once the effect finishes
+	UParticleSystemComponent* Emitter = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ParticleFX, Transform, true, EPSCPoolMethod::AutoRelease);
+	MyCombatStats::AddEmitterSpawned();
+	Spawned++;
+
+	if (Emitter && !SeenEmitters.Contains(Emitter))
+	{
+		SeenEmitters.Add(Emitter);
+		Misses++;
+		MyCombatStats::AddPooledEmitterMiss();
+		if (SeenEmitters.Num() >= PruneThreshold)
+		{
+			PruneSeenEmitters();
+		}
+	}
+	return Emitter;
+}
+
+void UMyCombatFXSubsystem::PruneSeenEmitters()
+{
+	//Drop components the pool has since destroyed, then wait for twice what's left before walking the set again
+	for (auto It = SeenEmitters.CreateIterator(); It; ++It)
+	{
+		if (!It->ResolveObjectPtr())
+		{
+			It.RemoveCurrent();
+		}
+	}
+	PruneThreshold = FMath::Max(SeenEmitters.Num() * 2, 1024);
+}
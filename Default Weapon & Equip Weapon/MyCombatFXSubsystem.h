@@ -0,0 +1,32 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "MyCombatFXSubsystem.generated.h"
+
+class UParticleSystem;
+class UParticleSystemComponent;
+
+//Spawns combat emitters through the world's particle component pool and counts pool misses for this world.
+//A component this world has never handed out before had to be created, so the pool had nothing free for that template.
+UCLASS()
+class UE5POINT5_SHOOTER_API UMyCombatFXSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+
+	UParticleSystemComponent* SpawnEmitter(UParticleSystem* ParticleFX, const FTransform& Transform);
+
+private:
+	void PruneSeenEmitters();
+
+	//Every component the pool has handed out. Pooled components stay alive, so only keys of destroyed ones are ever pruned.
+	TSet<TObjectKey<UParticleSystemComponent>> SeenEmitters;
+	int32 PruneThreshold = 1024;
+	int64 Spawned = 0;
+	int64 Misses = 0;
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cmath>
+
+//Aim, strafe and camera math with no engine dependency, so it can be built, tested and tuned on its own.
+//Vectors and rotators are templates over anything with X/Y/Z or Pitch/Yaw/Roll members (FVector, FRotator, plain structs).
+//Results match FMath::FInterpTo/VInterpTo/RInterpTo and FRotator::NormalizeAxis, the characters rely on that.
+namespace MyCombatMath
+{
+	constexpr float SmallNumber = 1.e-8f;
+	constexpr float KindaSmallNumber = 1.e-4f;
+	constexpr float RadiansToDegrees = 57.295779513082320876f;
+
+	constexpr float MaxShotRange = 50'000.f; //Crosshair and barrel traces both stop here
+
+	template<typename T>
+	constexpr T Clamp01(T Value)
+	{
+		return Value < T(0) ? T(0) : (Value > T(1) ? T(1) : Value);
+	}
+
+	//Angle in degrees to (-180, 180]
+	template<typename T>
+	T NormalizeAxis(T Angle)
+	{
+		Angle = std::fmod(Angle, T(360));
+		if (Angle < T(0))
+		{
+			Angle += T(360);
+		}
+		return Angle > T(180) ? Angle - T(360) : Angle;
+	}
+
+	template<typename T>
+	T InterpTo(T Current, T Target, T DeltaTime, T InterpSpeed)
+	{
+		if (InterpSpeed <= T(0))
+		{
+			return Target;
+		}
+		const T Dist = Target - Current;
+		if (Dist * Dist < T(SmallNumber))
+		{
+			return Target;
+		}
+		return Current + Dist * Clamp01(DeltaTime * InterpSpeed);
+	}
+
+	template<typename VectorType, typename T>
+	VectorType VectorInterpTo(const VectorType& Current, const VectorType& Target, T DeltaTime, T InterpSpeed)
+	{
+		if (InterpSpeed <= T(0))
+		{
+			return Target;
+		}
+		const auto DX = Target.X - Current.X;
+		const auto DY = Target.Y - Current.Y;
+		const auto DZ = Target.Z - Current.Z;
+		if (DX * DX + DY * DY + DZ * DZ < KindaSmallNumber)
+		{
+			return Target;
+		}
+		const auto Alpha = Clamp01(DeltaTime * InterpSpeed);
+		VectorType Result = Current;
+		Result.X += DX * Alpha;
+		Result.Y += DY * Alpha;
+		Result.Z += DZ * Alpha;
+		return Result;
+	}
+
+	template<typename RotatorType, typename T>
+	RotatorType RotatorInterpTo(const RotatorType& Current, const RotatorType& Target, T DeltaTime, T InterpSpeed)
+	{
+		if (DeltaTime == T(0) || (Current.Pitch == Target.Pitch && Current.Yaw == Target.Yaw && Current.Roll == Target.Roll))
+		{
+			return Current;
+		}
+		if (InterpSpeed <= T(0))
+		{
+			return Target;
+		}
+		//Shortest way round on every axis
+		const auto DPitch = NormalizeAxis(Target.Pitch - Current.Pitch);
+		const auto DYaw = NormalizeAxis(Target.Yaw - Current.Yaw);
+		const auto DRoll = NormalizeAxis(Target.Roll - Current.Roll);
+		if (std::abs(DPitch) <= KindaSmallNumber && std::abs(DYaw) <= KindaSmallNumber && std::abs(DRoll) <= KindaSmallNumber)
+		{
+			return Target;
+		}
+		const auto Alpha = Clamp01(InterpSpeed * DeltaTime);
+		RotatorType Result = Current;
+		Result.Pitch = NormalizeAxis(Current.Pitch + DPitch * Alpha);
+		Result.Yaw = NormalizeAxis(Current.Yaw + DYaw * Alpha);
+		Result.Roll = NormalizeAxis(Current.Roll + DRoll * Alpha);
+		return Result;
+	}
+
+	//Yaw of the movement direction relative to the aim yaw, in (-180, 180]. Standing still reads as moving along world X.
+	template<typename T>
+	T StrafeYaw(T VelocityX, T VelocityY, T AimYaw)
+	{
+		const T MoveYaw = std::atan2(VelocityY, VelocityX) * T(RadiansToDegrees);
+		return NormalizeAxis(MoveYaw - AimYaw);
+	}
+
+	//Where a shot from Start along the unit Direction stops when it hits nothing
+	template<typename VectorType>
+	VectorType ShotTraceEnd(const VectorType& Start, const VectorType& Direction, float Range = MaxShotRange)
+	{
+		VectorType Result = Start;
+		Result.X += Direction.X * Range;
+		Result.Y += Direction.Y * Range;
+		Result.Z += Direction.Z * Range;
+		return Result;
+	}
+}
@@ -0,0 +1,407 @@
+#include "MyCombatReplaySubsystem.h"
+#include "MyCharacter.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+enum EMyReplayButtons : uint8
+{
+	EMRB_Fire = 1 << 0,
+	EMRB_Aim = 1 << 1,
+	EMRB_Ultimate = 1 << 2,
+	EMRB_Pickup = 1 << 3
+};
+
+FMyReplayInput FMyReplayInput::Quantize(const FMyBotInput& Input)
+{
+	auto QuantizeAxis = [](float Value) { return static_cast<int8>(FMath::RoundToInt(FMath::Clamp(Value, -1.f, 1.f) * 127.f)); };
+
+	FMyReplayInput Quantized;
+	Quantized.MoveForward = QuantizeAxis(Input.MoveForward);
+	Quantized.MoveRight = QuantizeAxis(Input.MoveRight);
+	Quantized.TurnRate = QuantizeAxis(Input.TurnRate);
+	Quantized.LookUpRate = QuantizeAxis(Input.LookUpRate);
+	Quantized.Buttons = (Input.bFire ? EMRB_Fire : 0) | (Input.bAim ? EMRB_Aim : 0) | (Input.bUltimate ? EMRB_Ultimate : 0) | (Input.bPickup ? EMRB_Pickup : 0);
+	return Quantized;
+}
+
+FMyBotInput FMyReplayInput::ToBotInput() const
+{
+	FMyBotInput Input;
+	Input.MoveForward = MoveForward / 127.f;
+	Input.MoveRight = MoveRight / 127.f;
+	Input.TurnRate = TurnRate / 127.f;
+	Input.LookUpRate = LookUpRate / 127.f;
+	Input.bFire = (Buttons & EMRB_Fire) != 0;
+	Input.bAim = (Buttons & EMRB_Aim) != 0;
+	Input.bUltimate = (Buttons & EMRB_Ultimate) != 0;
+	Input.bPickup = (Buttons & EMRB_Pickup) != 0;
+	return Input;
+}
+
+bool FMyReplayInput::AxesEqual(const FMyReplayInput& Other) const
+{
+	return MoveForward == Other.MoveForward && MoveRight == Other.MoveRight && TurnRate == Other.TurnRate && LookUpRate == Other.LookUpRate;
+}
+
+bool UMyCombatReplaySubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	FString Path;
+	return Super::ShouldCreateSubsystem(Outer) &&
+		(FParse::Value(FCommandLine::Get(), TEXT("CombatRecord="), Path) || FParse::Value(FCommandLine::Get(), TEXT("CombatReplay="), Path));
+}
+
+bool UMyCombatReplaySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game;
+}
+
+TStatId UMyCombatReplaySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMyCombatReplaySubsystem, STATGROUP_Tickables);
+}
+
+void UMyCombatReplaySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+	bPlayback = FParse::Value(CommandLine, TEXT("CombatReplay="), FilePath);
+	if (!bPlayback)
+	{
+		FParse::Value(CommandLine, TEXT("CombatRecord="), FilePath);
+	}
+	if (FPaths::IsRelative(FilePath))
+	{
+		FilePath = FPaths::ProfilingDir() / TEXT("Replays") / FilePath;
+	}
+
+	bFinished = false;
+	SimHz = 30.f;
+	NumWeapons = 0;
+	Seed = 1;
+	NumFrames = 0;
+	FrameIndex = 0;
+	FrameReadOffset = 0;
+	PlaybackStartSeconds = 0.0;
+	FParse::Value(CommandLine, TEXT("CombatSimHz="), SimHz);
+	FParse::Value(CommandLine, TEXT("SoakWeapons="), NumWeapons);
+	FParse::Value(CommandLine, TEXT("SoakSeed="), Seed);
+
+	if (bPlayback && !LoadReplay(FilePath))
+	{
+		bFinished = true;
+		FPlatformMisc::RequestExitWithStatus(false, 1);
+		return;
+	}
+
+	//Same step on record and playback, otherwise the same inputs don't make the same match
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(1.0 / SimHz);
+}
+
+void UMyCombatReplaySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	StartCounters = MyCombatStats::GetCounters();
+	OutcomeCounters = StartCounters;
+	if (bPlayback && !bFinished)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Replay: playing %s, %d bots, %d frames at %.0f Hz"), *FilePath, InitialStates.Num(), NumFrames, SimHz);
+		PlaybackStartSeconds = FPlatformTime::Seconds();
+		DecodeFrame();
+	}
+	else if (!bPlayback)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Replay: recording to %s at %.0f Hz"), *FilePath, SimHz);
+	}
+}
+
+void UMyCombatReplaySubsystem::Deinitialize()
+{
+	if (!bPlayback && NumFrames > 0)
+	{
+		SaveRecording();
+	}
+	else if (bPlayback && !bFinished)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Replay: world ended after %d of %d frames, nothing verified"), FrameIndex, NumFrames);
+	}
+	Super::Deinitialize();
+}
+
+int32 UMyCombatReplaySubsystem::RegisterBot(AMyCharacter* Bot, AController* BotController)
+{
+	const int32 BotIndex = Bots.Num();
+	if (bPlayback)
+	{
+		if (!InitialStates.IsValidIndex(BotIndex))
+		{
+			return INDEX_NONE; //More bots than were recorded, leave the extras to themselves
+		}
+		//Start exactly where the recording did
+		const FMyReplayBotState& State = InitialStates[BotIndex];
+		Bot->SetActorLocationAndRotation(State.Location, State.Rotation, false, nullptr, ETeleportType::ResetPhysics);
+		BotController->SetControlRotation(State.ControlRotation);
+	}
+	else
+	{
+		FMyReplayBotState& State = InitialStates.AddDefaulted_GetRef();
+		State.Location = Bot->GetActorLocation();
+		State.Rotation = Bot->GetActorRotation();
+		State.ControlRotation = BotController->GetControlRotation();
+		FrameInputs.AddDefaulted();
+		PreviousInputs.AddDefaulted();
+		FinalLocations.Add(State.Location);
+	}
+	Bots.Add(Bot);
+	return BotIndex;
+}
+
+FMyBotInput UMyCombatReplaySubsystem::ProcessInput(int32 BotIndex, const FMyBotInput& Decided)
+{
+	if (!FrameInputs.IsValidIndex(BotIndex) || (bPlayback && bFinished))
+	{
+		return bPlayback ? FMyBotInput() : Decided;
+	}
+	if (!bPlayback)
+	{
+		FrameInputs[BotIndex] = FMyReplayInput::Quantize(Decided);
+	}
+	return FrameInputs[BotIndex].ToBotInput();
+}
+
+void UMyCombatReplaySubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	if (bFinished)
+	{
+		return;
+	}
+
+	if (!bPlayback)
+	{
+		//Buttons are one byte per bot and frame, axes only follow when they changed
+		for (int32 BotIndex = 0; BotIndex < FrameInputs.Num(); BotIndex++)
+		{
+			const FMyReplayInput& Input = FrameInputs[BotIndex];
+			const bool bAxesChanged = !Input.AxesEqual(PreviousInputs[BotIndex]);
+			FrameData.Add(Input.Buttons | (bAxesChanged ? AxesChangedBit : 0));
+			if (bAxesChanged)
+			{
+				FrameData.Add(static_cast<uint8>(Input.MoveForward));
+				FrameData.Add(static_cast<uint8>(Input.MoveRight));
+				FrameData.Add(static_cast<uint8>(Input.TurnRate));
+				FrameData.Add(static_cast<uint8>(Input.LookUpRate));
+			}
+			PreviousInputs[BotIndex] = Input;
+			FrameInputs[BotIndex] = FMyReplayInput(); //A bot that doesn't think next frame records as idle
+		}
+		NumFrames++;
+		CaptureOutcome();
+		return;
+	}
+
+	FrameIndex++;
+	CaptureOutcome();
+	if (FrameIndex >= NumFrames)
+	{
+		FinishPlayback();
+		return;
+	}
+	DecodeFrame();
+}
+
+void UMyCombatReplaySubsystem::DecodeFrame()
+{
+	for (int32 BotIndex = 0; BotIndex < FrameInputs.Num(); BotIndex++)
+	{
+		FMyReplayInput Input = PreviousInputs[BotIndex];
+		if (FrameReadOffset + 1 > FrameData.Num())
+		{
+			FailTruncated(BotIndex);
+			return;
+		}
+		const uint8 Flags = FrameData[FrameReadOffset++];
+		Input.Buttons = Flags & ~AxesChangedBit;
+		if (Flags & AxesChangedBit)
+		{
+			if (FrameReadOffset + 4 > FrameData.Num())
+			{
+				FailTruncated(BotIndex);
+				return;
+			}
+			Input.MoveForward = static_cast<int8>(FrameData[FrameReadOffset++]);
+			Input.MoveRight = static_cast<int8>(FrameData[FrameReadOffset++]);
+			Input.TurnRate = static_cast<int8>(FrameData[FrameReadOffset++]);
+			Input.LookUpRate = static_cast<int8>(FrameData[FrameReadOffset++]);
+		}
+		FrameInputs[BotIndex] = Input;
+		PreviousInputs[BotIndex] = Input;
+	}
+}
+
+void UMyCombatReplaySubsystem::FailTruncated(int32 BotIndex)
+{
+	UE_LOG(LogTemp, Error, TEXT("Replay: %s ends early, frame %d of %d has no input for bot %d (%d bytes read)"),
+		*FilePath, FrameIndex, NumFrames, BotIndex, FrameReadOffset);
+	bFinished = true;
+	FPlatformMisc::RequestExitWithStatus(false, 1);
+}
+
+void UMyCombatReplaySubsystem::CaptureOutcome()
+{
+	OutcomeCounters = MyCombatStats::GetCounters();
+	for (int32 BotIndex = 0; BotIndex < Bots.Num() && BotIndex < FinalLocations.Num(); BotIndex++)
+	{
+		if (const AMyCharacter* Bot = Bots[BotIndex].Get())
+		{
+			FinalLocations[BotIndex] = Bot->GetActorLocation();
+		}
+	}
+}
+
+void UMyCombatReplaySubsystem::SerializeHeader(FArchive& Ar)
+{
+	uint32 Magic = FileMagic;
+	uint16 Version = FileVersion;
+	Ar << Magic;
+	Ar << Version;
+	if (Ar.IsLoading() && (Magic != FileMagic || Version != FileVersion))
+	{
+		Ar.SetError();
+		return;
+	}
+
+	Ar << SimHz;
+	Ar << NumWeapons;
+	Ar << Seed;
+	int32 NumBots = InitialStates.Num();
+	Ar << NumBots;
+	if (Ar.IsLoading())
+	{
+		InitialStates.SetNum(FMath::Clamp(NumBots, 0, 4096));
+	}
+	for (FMyReplayBotState& State : InitialStates)
+	{
+		Ar << State.Location;
+		Ar << State.Rotation;
+		Ar << State.ControlRotation;
+	}
+}
+
+void UMyCombatReplaySubsystem::SerializeOutcome(FArchive& Ar, FMyCombatCounters& Counters, TArray<FVector>& Locations)
+{
+	Ar << Counters.ShotsFired;
+	Ar << Counters.Hits;
+	Ar << Counters.Traces;
+	Ar << Counters.UltimatesUsed;
+	Ar << Counters.ItemsPickedUp;
+	Ar << Locations;
+}
+
+bool UMyCombatReplaySubsystem::LoadReplay(const FString& Path)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Path))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Replay: can't read %s"), *Path);
+		return false;
+	}
+
+	FMemoryReader Ar(Bytes);
+	SerializeHeader(Ar);
+	Ar << NumFrames;
+	Ar << FrameData;
+	SerializeOutcome(Ar, ExpectedCounters, ExpectedLocations);
+	//Every bot stores at least its flags byte per frame, DecodeFrame checks the axes that follow
+	if (Ar.IsError() || ExpectedLocations.Num() != InitialStates.Num() || NumFrames < 0
+		|| FrameData.Num() < static_cast<int64>(NumFrames) * InitialStates.Num())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Replay: %s is not a version %d replay"), *Path, FileVersion);
+		return false;
+	}
+
+	int32 RequestedWeapons = NumWeapons;
+	int32 RequestedSeed = Seed;
+	FParse::Value(FCommandLine::Get(), TEXT("SoakWeapons="), RequestedWeapons);
+	FParse::Value(FCommandLine::Get(), TEXT("SoakSeed="), RequestedSeed);
+	if (RequestedWeapons != NumWeapons || RequestedSeed != Seed)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Replay: recorded with -SoakWeapons=%d -SoakSeed=%d, the world may differ"), NumWeapons, Seed);
+	}
+
+	FrameInputs.SetNum(InitialStates.Num());
+	PreviousInputs.SetNum(InitialStates.Num());
+	FinalLocations.SetNumZeroed(InitialStates.Num());
+	return true;
+}
+
+void UMyCombatReplaySubsystem::SaveRecording()
+{
+	FMyCombatCounters Outcome;
+	Outcome.ShotsFired = OutcomeCounters.ShotsFired - StartCounters.ShotsFired;
+	Outcome.Hits = OutcomeCounters.Hits - StartCounters.Hits;
+	Outcome.Traces = OutcomeCounters.Traces - StartCounters.Traces;
+	Outcome.UltimatesUsed = OutcomeCounters.UltimatesUsed - StartCounters.UltimatesUsed;
+	Outcome.ItemsPickedUp = OutcomeCounters.ItemsPickedUp - StartCounters.ItemsPickedUp;
+
+	TArray<uint8> Bytes;
+	FMemoryWriter Ar(Bytes);
+	SerializeHeader(Ar);
+	Ar << NumFrames;
+	Ar << FrameData;
+	SerializeOutcome(Ar, Outcome, FinalLocations);
+
+	if (FFileHelper::SaveArrayToFile(Bytes, *FilePath))
+	{
+		UE_LOG(LogTemp, Log, TEXT("Replay: saved %s, %d bots, %d frames, %d bytes (%.1f per frame)"),
+			*FilePath, InitialStates.Num(), NumFrames, Bytes.Num(), static_cast<float>(Bytes.Num()) / NumFrames);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("Replay: can't write %s"), *FilePath);
+	}
+}
+
+void UMyCombatReplaySubsystem::FinishPlayback()
+{
+	bFinished = true;
+	const double WallSeconds = FMath::Max(FPlatformTime::Seconds() - PlaybackStartSeconds, 0.001);
+
+	bool bMatches = true;
+	auto Compare = [&bMatches](const TCHAR* Name, int64 Expected, int64 Actual)
+	{
+		if (Expected != Actual)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Replay: %s %lld, recorded %lld"), Name, Actual, Expected);
+			bMatches = false;
+		}
+	};
+	Compare(TEXT("shots"), ExpectedCounters.ShotsFired, OutcomeCounters.ShotsFired - StartCounters.ShotsFired);
+	Compare(TEXT("hits"), ExpectedCounters.Hits, OutcomeCounters.Hits - StartCounters.Hits);
+	Compare(TEXT("traces"), ExpectedCounters.Traces, OutcomeCounters.Traces - StartCounters.Traces);
+	Compare(TEXT("ultimates"), ExpectedCounters.UltimatesUsed, OutcomeCounters.UltimatesUsed - StartCounters.UltimatesUsed);
+	Compare(TEXT("pickups"), ExpectedCounters.ItemsPickedUp, OutcomeCounters.ItemsPickedUp - StartCounters.ItemsPickedUp);
+
+	static constexpr float PositionTolerance = 1.f; //cm
+	for (int32 BotIndex = 0; BotIndex < ExpectedLocations.Num(); BotIndex++)
+	{
+		if (!FinalLocations[BotIndex].Equals(ExpectedLocations[BotIndex], PositionTolerance))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Replay: bot %d ended at %s, recorded %s"), BotIndex, *FinalLocations[BotIndex].ToString(), *ExpectedLocations[BotIndex].ToString());
+			bMatches = false;
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Replay: %s, %d frames in %.2f s, %.3f ms per frame, %.1fx real time"),
+		bMatches ? TEXT("outcome matches the recording") : TEXT("OUTCOME DIFFERS from the recording"),
+		NumFrames, WallSeconds, WallSeconds * 1000.0 / NumFrames, NumFrames / SimHz / WallSeconds);
+	FPlatformMisc::RequestExitWithStatus(false, bMatches ? 0 : 1);
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MyBotController.h"
+#include "MyCombatStats.h"
+#include "MyCombatReplaySubsystem.generated.h"
+
+class AMyCharacter;
+
+//Quantized FMyBotInput as stored in a replay: axes in 1/127 steps, buttons as bits
+struct FMyReplayInput
+{
+	int8 MoveForward = 0;
+	int8 MoveRight = 0;
+	int8 TurnRate = 0;
+	int8 LookUpRate = 0;
+	uint8 Buttons = 0;
+
+	static FMyReplayInput Quantize(const FMyBotInput& Input);
+	FMyBotInput ToBotInput() const;
+	bool AxesEqual(const FMyReplayInput& Other) const;
+};
+
+//Where a bot was when recording started, playback teleports it there before the first frame
+struct FMyReplayBotState
+{
+	FVector Location = FVector::ZeroVector;
+	FRotator Rotation = FRotator::ZeroRotator;
+	FRotator ControlRotation = FRotator::ZeroRotator;
+};
+
+//Records bot inputs every frame into a compact binary file, or plays such a file back instead of the bots' own decisions.
+//  -CombatRecord=<file>   record this run (relative paths go to Saved/Profiling/Replays/)
+//  -CombatReplay=<file>   drive the bots from the file, verify the outcome and report timing, then quit
+//Both run at a fixed time step (-CombatSimHz, the recorded rate on playback), so pair them with -CombatSim and the same
+//-SoakBots/-SoakWeapons/-SoakSeed for identical workloads. Playback exits with code 1 when hits, shots or final positions differ.
+//File: header (version, rate, bot count, soak setup, initial bot states), then per frame and bot one button byte with a flag
+//for changed axes followed by the four axes only when they changed, then the recorded outcome.
+UCLASS()
+class UE5POINT5_SHOOTER_API UMyCombatReplaySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	//Called by bots on possession, in spawn order. Returns the bot's replay slot, INDEX_NONE when it isn't part of the replay.
+	int32 RegisterBot(AMyCharacter* Bot, AController* BotController);
+	//The input the bot applies this frame: its own decision quantized like the file stores it, or the recorded one on playback
+	FMyBotInput ProcessInput(int32 BotIndex, const FMyBotInput& Decided);
+	FORCEINLINE bool IsPlayingBack() const { return bPlayback; }
+	FORCEINLINE float GetSimHz() const { return SimHz; } //The recorded rate on playback
+
+private:
+	static constexpr uint32 FileMagic = 0x59504552; //"REPY"
+	static constexpr uint16 FileVersion = 1;
+	static constexpr uint8 AxesChangedBit = 0x80;
+
+	bool LoadReplay(const FString& Path);
+	void SaveRecording();
+	void SerializeHeader(FArchive& Ar);
+	static void SerializeOutcome(FArchive& Ar, FMyCombatCounters& Counters, TArray<FVector>& Locations);
+	void DecodeFrame();
+	void FailTruncated(int32 BotIndex);
+	void CaptureOutcome();
+	void FinishPlayback();
+
+	FString FilePath;
+	bool bPlayback;
+	bool bFinished;
+	float SimHz;
+	int32 NumWeapons;
+	int32 Seed;
+	int32 NumFrames;
+	int32 FrameIndex;
+
+	TArray<TWeakObjectPtr<AMyCharacter>> Bots;
+	TArray<FMyReplayBotState> InitialStates;
+	TArray<FMyReplayInput> FrameInputs; //Current frame, one per bot
+	TArray<FMyReplayInput> PreviousInputs; //Last frame written/read, axes are only stored when they change
+
+	TArray<uint8> FrameData; //Encoded frames, written out with the header on save
+	int64 FrameReadOffset;
+
+	//Outcome, taken at the end of every frame so the last one is ready whenever the run ends
+	FMyCombatCounters StartCounters;
+	FMyCombatCounters OutcomeCounters;
+	TArray<FVector> FinalLocations;
+	FMyCombatCounters ExpectedCounters;
+	TArray<FVector> ExpectedLocations;
+
+	double PlaybackStartSeconds;
+};
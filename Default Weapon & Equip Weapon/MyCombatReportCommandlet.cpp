@@ -0,0 +1,206 @@
+#include "MyCombatReportCommandlet.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	//Nearest rank percentile of an already sorted array
+	float Percentile(const TArray<float>& Sorted, float Fraction)
+	{
+		if (Sorted.Num() == 0)
+		{
+			return 0.f;
+		}
+		const int32 Rank = FMath::CeilToInt(Fraction * Sorted.Num()) - 1;
+		return Sorted[FMath::Clamp(Rank, 0, Sorted.Num() - 1)];
+	}
+
+	struct FColumnSummary
+	{
+		FString Name;
+		double Total = 0.0;
+		double SpikeTotal = 0.0;
+		int32 Frames = 0;
+		int32 SpikeFrames = 0;
+
+		double GetMean() const { return Frames > 0 ? Total / Frames : 0.0; }
+		double GetSpikeMean() const { return SpikeFrames > 0 ? SpikeTotal / SpikeFrames : 0.0; }
+	};
+}
+
+UMyCombatReportCommandlet::UMyCombatReportCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UMyCombatReportCommandlet::Main(const FString& Params)
+{
+	FString CsvPath;
+	if (!FParse::Value(*Params, TEXT("Csv="), CsvPath))
+	{
+		CsvPath = FPaths::ProfilingDir() / TEXT("CSV");
+	}
+	int32 NumTopOffenders = 10;
+	FParse::Value(*Params, TEXT("Top="), NumTopOffenders);
+
+	TArray<FString> CsvFiles;
+	if (IFileManager::Get().DirectoryExists(*CsvPath))
+	{
+		IFileManager::Get().FindFilesRecursive(CsvFiles, *CsvPath, TEXT("*.csv"), true, false);
+	}
+	else if (IFileManager::Get().FileExists(*CsvPath))
+	{
+		CsvFiles.Add(CsvPath);
+	}
+	if (CsvFiles.Num() == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("CombatReport: no CSV files at %s"), *CsvPath);
+		return 1;
+	}
+
+	int32 NumFailed = 0;
+	for (const FString& CsvFile : CsvFiles)
+	{
+		if (!WriteReport(CsvFile, NumTopOffenders))
+		{
+			NumFailed++;
+		}
+	}
+	UE_LOG(LogTemp, Display, TEXT("CombatReport: %d of %d captures summarized"), CsvFiles.Num() - NumFailed, CsvFiles.Num());
+	return NumFailed > 0 ? 1 : 0;
+}
+
+bool UMyCombatReportCommandlet::WriteReport(const FString& CsvFile, int32 NumTopOffenders) const
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *CsvFile) || Lines.Num() < 2)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("CombatReport: %s is empty or unreadable"), *CsvFile);
+		return false;
+	}
+
+	TArray<FString> Header;
+	Lines[0].ParseIntoArray(Header, TEXT(","), false);
+	const int32 FrameTimeColumn = Header.IndexOfByKey(TEXT("FrameTime"));
+	if (FrameTimeColumn == INDEX_NONE)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("CombatReport: %s has no FrameTime column, not a CSV profiler capture"), *CsvFile);
+		return false;
+	}
+
+	//One row per frame. The capture ends with a repeat of the header and the metadata rows, the first non numeric
+	//FrameTime cell marks where the frames stop.
+	TArray<TArray<float>> Frames;
+	Frames.Reserve(Lines.Num());
+	TArray<FString> Cells;
+	FString Metadata;
+	for (int32 LineIndex = 1; LineIndex < Lines.Num(); LineIndex++)
+	{
+		Lines[LineIndex].ParseIntoArray(Cells, TEXT(","), false);
+		if (!Cells.IsValidIndex(FrameTimeColumn) || !Cells[FrameTimeColumn].IsNumeric())
+		{
+			if (Lines[LineIndex].StartsWith(TEXT("[")))
+			{
+				Metadata = Lines[LineIndex];
+			}
+			continue;
+		}
+		TArray<float>& Frame = Frames.AddDefaulted_GetRef();
+		Frame.SetNumZeroed(Header.Num());
+		for (int32 Column = 0; Column < Header.Num() && Column < Cells.Num(); Column++)
+		{
+			Frame[Column] = Cells[Column].IsNumeric() ? FCString::Atof(*Cells[Column]) : 0.f;
+		}
+	}
+	if (Frames.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("CombatReport: %s has no frames"), *CsvFile);
+		return false;
+	}
+
+	TArray<float> FrameTimes;
+	FrameTimes.Reserve(Frames.Num());
+	for (const TArray<float>& Frame : Frames)
+	{
+		FrameTimes.Add(Frame[FrameTimeColumn]);
+	}
+	FrameTimes.Sort();
+	const float SpikeThreshold = Percentile(FrameTimes, 0.99f);
+
+	TArray<FColumnSummary> Columns;
+	Columns.SetNum(Header.Num());
+	for (int32 Column = 0; Column < Header.Num(); Column++)
+	{
+		Columns[Column].Name = Header[Column];
+	}
+	for (const TArray<float>& Frame : Frames)
+	{
+		const bool bSpike = Frame[FrameTimeColumn] >= SpikeThreshold;
+		for (int32 Column = 0; Column < Header.Num(); Column++)
+		{
+			FColumnSummary& Summary = Columns[Column];
+			Summary.Total += Frame[Column];
+			Summary.Frames++;
+			if (bSpike)
+			{
+				Summary.SpikeTotal += Frame[Column];
+				Summary.SpikeFrames++;
+			}
+		}
+	}
+
+	double FrameTimeTotal = 0.0;
+	for (float FrameTime : FrameTimes)
+	{
+		FrameTimeTotal += FrameTime;
+	}
+
+	FString Report;
+	Report += FString::Printf(TEXT("Combat report for %s\n"), *FPaths::GetCleanFilename(CsvFile));
+	if (!Metadata.IsEmpty())
+	{
+		Report += FString::Printf(TEXT("Metadata: %s\n"), *Metadata);
+	}
+	Report += FString::Printf(TEXT("Frames: %d, %.1f s\n"), Frames.Num(), FrameTimeTotal / 1000.0);
+	Report += FString::Printf(TEXT("Frame time ms: avg %.2f, p50 %.2f, p95 %.2f, p99 %.2f, max %.2f\n"),
+		FrameTimeTotal / Frames.Num(), Percentile(FrameTimes, 0.5f), Percentile(FrameTimes, 0.95f), SpikeThreshold, FrameTimes.Last());
+
+	Report += TEXT("\nShooterCombat per frame (avg, in slowest 1%)\n");
+	for (const FColumnSummary& Summary : Columns)
+	{
+		if (Summary.Name.StartsWith(TEXT("ShooterCombat/")))
+		{
+			Report += FString::Printf(TEXT("  %-40s %10.3f %10.3f\n"), *Summary.Name, Summary.GetMean(), Summary.GetSpikeMean());
+		}
+	}
+
+	//Whatever grows the most when the frame is slow. Timings are in ms and counts are per frame, so read the list
+	//as "what moved", not as a breakdown of the spike.
+	TArray<const FColumnSummary*> Offenders;
+	for (int32 Column = 0; Column < Columns.Num(); Column++)
+	{
+		if (Column != FrameTimeColumn && Columns[Column].GetSpikeMean() > Columns[Column].GetMean())
+		{
+			Offenders.Add(&Columns[Column]);
+		}
+	}
+	Offenders.Sort([](const FColumnSummary& A, const FColumnSummary& B)
+	{
+		return A.GetSpikeMean() - A.GetMean() > B.GetSpikeMean() - B.GetMean();
+	});
+	Report += FString::Printf(TEXT("\nTop offenders in frames over %.2f ms (avg, in slowest 1%%, growth)\n"), SpikeThreshold);
+	for (int32 Index = 0; Index < Offenders.Num() && Index < NumTopOffenders; Index++)
+	{
+		const FColumnSummary& Summary = *Offenders[Index];
+		Report += FString::Printf(TEXT("  %-40s %10.3f %10.3f %+10.3f\n"), *Summary.Name, Summary.GetMean(), Summary.GetSpikeMean(), Summary.GetSpikeMean() - Summary.GetMean());
+	}
+
+	const FString ReportFile = FPaths::ChangeExtension(CsvFile, TEXT("summary.txt"));
+	FFileHelper::SaveStringToFile(Report, *ReportFile);
+	UE_LOG(LogTemp, Display, TEXT("%s"), *Report);
+	return true;
+}
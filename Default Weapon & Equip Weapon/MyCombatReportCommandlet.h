@@ -0,0 +1,23 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MyCombatReportCommandlet.generated.h"
+
+//Turns CSV profiler captures from unattended matches into per-match summaries. Needs no map, RHI or assets, so it runs
+//offline on a Linux build box:
+//  UnrealEditor-Cmd UE5Point5_Shooter -run=MyCombatReport -Csv=<file or folder> [-Top=N] [-nullrhi]
+//For every .csv found a <name>.summary.txt is written next to it with frame time p50/p95/p99, ShooterCombat totals
+//per frame and the columns that grow the most in the slowest 1% of frames.
+UCLASS()
+class UE5POINT5_SHOOTER_API UMyCombatReportCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UMyCombatReportCommandlet();
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	bool WriteReport(const FString& CsvFile, int32 NumTopOffenders) const;
+};
@@ -0,0 +1,125 @@
+#include "MyCombatSimSubsystem.h"
+#include "MyCombatReplaySubsystem.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+bool UMyCombatSimSubsystem::IsCombatSimulation()
+{
+	static const bool bCombatSimulation = FParse::Param(FCommandLine::Get(), TEXT("CombatSim"));
+	return bCombatSimulation;
+}
+
+bool UMyCombatSimSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return Super::ShouldCreateSubsystem(Outer) && IsCombatSimulation();
+}
+
+bool UMyCombatSimSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game;
+}
+
+TStatId UMyCombatSimSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMyCombatSimSubsystem, STATGROUP_Tickables);
+}
+
+void UMyCombatSimSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	SimHz = 30.f;
+	SimSecondsLimit = 0.f;
+	FParse::Value(FCommandLine::Get(), TEXT("CombatSimHz="), SimHz);
+	FParse::Value(FCommandLine::Get(), TEXT("CombatSimSeconds="), SimSecondsLimit);
+	SimHz = FMath::Clamp(SimHz, 1.f, 1000.f);
+
+	//A replay only reproduces its match at the step it was recorded with. Loading it first also means we set the step last.
+	const UMyCombatReplaySubsystem* Replay = Cast<UMyCombatReplaySubsystem>(Collection.InitializeDependency(UMyCombatReplaySubsystem::StaticClass()));
+	if (Replay && Replay->IsPlayingBack() && Replay->GetSimHz() != SimHz)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("CombatSim: replay was recorded at %.0f Hz, running at that instead of %.0f Hz"), Replay->GetSimHz(), SimHz);
+		SimHz = Replay->GetSimHz();
+	}
+
+	//Fixed step: the engine hands out exactly this delta every frame instead of measuring and waiting for wall time
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(1.0 / SimHz);
+
+	if (FApp::CanEverRender())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("CombatSim: rendering is on, pass -nullrhi for full speed"));
+	}
+	if (FApp::CanEverRenderAudio())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("CombatSim: audio is on, pass -nosound for full speed"));
+	}
+
+	SimSeconds = 0.0;
+	WallStartSeconds = 0.0;
+	SimFrames = 0;
+	bRunning = false;
+	bReported = false;
+}
+
+void UMyCombatSimSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	WallStartSeconds = FPlatformTime::Seconds();
+	bRunning = true;
+	UE_LOG(LogTemp, Log, TEXT("CombatSim: %.0f Hz fixed step, %s"), SimHz,
+		SimSecondsLimit > 0.f ? *FString::Printf(TEXT("stopping after %.0f simulated seconds"), SimSecondsLimit) : TEXT("no time limit"));
+}
+
+void UMyCombatSimSubsystem::Deinitialize()
+{
+	ReportSpeedUp(); //Whoever ended the match (soak, scenario, console), still report it
+	Super::Deinitialize();
+}
+
+void UMyCombatSimSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	if (!bRunning)
+	{
+		return;
+	}
+
+	SimSeconds += DeltaTime;
+	SimFrames++;
+	if (SimSecondsLimit > 0.f && SimSeconds >= SimSecondsLimit)
+	{
+		ReportSpeedUp();
+		bRunning = false;
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+void UMyCombatSimSubsystem::ReportSpeedUp()
+{
+	if (bReported || SimFrames == 0)
+	{
+		return;
+	}
+	bReported = true;
+
+	const double WallSeconds = FMath::Max(FPlatformTime::Seconds() - WallStartSeconds, 0.001);
+	const double SpeedUp = SimSeconds / WallSeconds;
+	UE_LOG(LogTemp, Log, TEXT("CombatSim: %.1f simulated s in %.1f wall s over %lld frames, %.1fx real time (%.3f ms per frame)"),
+		SimSeconds, WallSeconds, SimFrames, SpeedUp, WallSeconds * 1000.0 / SimFrames);
+
+	const FString ResultsPath = FPaths::ProfilingDir() / TEXT("Soak") / TEXT("CombatSim.csv");
+	if (!IFileManager::Get().FileExists(*ResultsPath))
+	{
+		FFileHelper::SaveStringToFile(TEXT("Map,Date,Hz,Frames,SimSeconds,WallSeconds,SpeedUp,CommandLine\n"), *ResultsPath);
+	}
+	const FString Row = FString::Printf(TEXT("%s,%s,%.0f,%lld,%.2f,%.2f,%.2f,\"%s\"\n"), *GetWorld()->GetMapName(), *FDateTime::Now().ToString(),
+		SimHz, SimFrames, SimSeconds, WallSeconds, SpeedUp, FCommandLine::Get());
+	FFileHelper::SaveStringToFile(Row, *ResultsPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+}
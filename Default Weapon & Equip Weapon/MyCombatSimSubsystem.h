@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MyCombatSimSubsystem.generated.h"
+
+//Faster than real time combat simulation for AI tuning and regression runs. Only created with -CombatSim:
+//  -CombatSimHz=N        fixed simulation rate, default 30. Every frame advances exactly 1/N seconds of game time
+//                        and the engine never waits for the wall clock. Playing back a -CombatReplay uses its recorded rate instead
+//  -CombatSimSeconds=S   quit after S simulated seconds, 0 (default) runs until something else ends the match
+//Characters run with cosmetics off (no FX, sounds, montages, camera or item widgets), the same as on a dedicated server.
+//Rendering and audio can only be left out at startup, so pass -nullrhi -nosound; with -onethread everything runs on one core.
+//The achieved speed up (simulated seconds per wall clock second) is logged and appended to Saved/Profiling/Soak/CombatSim.csv.
+UCLASS()
+class UE5POINT5_SHOOTER_API UMyCombatSimSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	//True for the whole process when running with -CombatSim, usable before any world exists
+	static bool IsCombatSimulation();
+
+private:
+	void ReportSpeedUp();
+
+	float SimHz;
+	float SimSecondsLimit;
+	double SimSeconds; //Game time advanced since begin play
+	double WallStartSeconds;
+	int64 SimFrames;
+	bool bRunning;
+	bool bReported;
+};
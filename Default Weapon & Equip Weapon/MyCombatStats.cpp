@@ -0,0 +1,26 @@
+#include "MyCombatStats.h"
+
+DEFINE_STAT(STAT_ShooterTraces);
+DEFINE_STAT(STAT_ShooterShotsFired);
+DEFINE_STAT(STAT_ShooterEmittersSpawned);
+DEFINE_STAT(STAT_ShooterPooledEmitterMisses);
+DEFINE_STAT(STAT_ShooterPooledActorHits);
+DEFINE_STAT(STAT_ShooterPooledActorMisses);
+DEFINE_STAT(STAT_ShooterItemsInFocus);
+DEFINE_STAT(STAT_ShooterSoundsPlayed);
+DEFINE_STAT(STAT_ShooterSoundsCulled);
+
+UE_TRACE_CHANNEL_DEFINE(ShooterCombatChannel);
+CSV_DEFINE_CATEGORY_MODULE(UE5POINT5_SHOOTER_API, ShooterCombat, true);
+
+LLM_DEFINE_TAG(Shooter_Character);
+LLM_DEFINE_TAG(Shooter_Items);
+LLM_DEFINE_TAG(Shooter_Weapons);
+LLM_DEFINE_TAG(Shooter_CombatFX);
+LLM_DEFINE_TAG(Shooter_CombatAudio);
+
+FMyCombatCounters& MyCombatStats::GetCounters()
+{
+	static FMyCombatCounters Counters;
+	return Counters;
+}
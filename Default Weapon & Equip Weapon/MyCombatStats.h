@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "HAL/LowLevelMemTracker.h"
+
+//Running totals of combat work, sampled by the soak harness. Game thread only.
+struct FMyCombatCounters
+{
+	int64 Traces = 0;
+	int64 ShotsFired = 0;
+	int64 Hits = 0; //Server side shot hits, pellets count one each
+	int64 EmittersSpawned = 0;
+	int64 UltimatesUsed = 0;
+	int64 ItemsPickedUp = 0;
+	int64 SoundsPlayed = 0;
+	int64 SoundsCulled = 0;
+	int64 PooledEmitterMisses = 0;
+};
+
+//stat ShooterCombat: per frame counters plus a cycle stat for every hot combat function.
+//In Insights the same scopes show up on the ShooterCombat channel (-trace=cpu,ShooterCombat, or Trace.Enable ShooterCombat).
+DECLARE_STATS_GROUP(TEXT("ShooterCombat"), STATGROUP_ShooterCombat, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traces"), STAT_ShooterTraces, STATGROUP_ShooterCombat, UE5POINT5_SHOOTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Shots Fired"), STAT_ShooterShotsFired, STATGROUP_ShooterCombat, UE5POINT5_SHOOTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Emitters Spawned"), STAT_ShooterEmittersSpawned, STATGROUP_ShooterCombat, UE5POINT5_SHOOTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pooled Emitter Misses"), STAT_ShooterPooledEmitterMisses, STATGROUP_ShooterCombat, UE5POINT5_SHOOTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pooled Actor Hits"), STAT_ShooterPooledActorHits, STATGROUP_ShooterCombat, UE5POINT5_SHOOTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pooled Actor Misses"), STAT_ShooterPooledActorMisses, STATGROUP_ShooterCombat, UE5POINT5_SHOOTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Items In Focus"), STAT_ShooterItemsInFocus, STATGROUP_ShooterCombat, UE5POINT5_SHOOTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Sounds Played"), STAT_ShooterSoundsPlayed, STATGROUP_ShooterCombat, UE5POINT5_SHOOTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Sounds Culled"), STAT_ShooterSoundsCulled, STATGROUP_ShooterCombat, UE5POINT5_SHOOTER_API);
+
+UE_TRACE_CHANNEL_EXTERN(ShooterCombatChannel, UE5POINT5_SHOOTER_API);
+
+//CSV profiler category (-csvprofile / csvprofile start). Every counter below is also accumulated per frame into it,
+//run -run=MyCombatReport over the captured CSVs for a per-match summary.
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(UE5POINT5_SHOOTER_API, ShooterCombat);
+
+//Low level memory tracker tags (-llm, stat LLMFULL, or Insights memory). Show up as Shooter/Character, Shooter/Items, ...
+//Wrap allocation sites with LLM_SCOPE_BYTAG(Shooter_Character); compiles out with LLM and costs a branch when not running -llm.
+LLM_DECLARE_TAG_API(Shooter_Character, UE5POINT5_SHOOTER_API); //Characters, their components and per character scratch
+LLM_DECLARE_TAG_API(Shooter_Items, UE5POINT5_SHOOTER_API); //Pickup actors: meshes, colliders and widgets
+LLM_DECLARE_TAG_API(Shooter_Weapons, UE5POINT5_SHOOTER_API); //Spawned/equipped weapons and their baked tables
+LLM_DECLARE_TAG_API(Shooter_CombatFX, UE5POINT5_SHOOTER_API); //Emitters and pooled decals
+LLM_DECLARE_TAG_API(Shooter_CombatAudio, UE5POINT5_SHOOTER_API); //Combat sound dispatch and its concurrency/attenuation objects
+
+//Cycle stat and Insights scope in one. Both cost a branch when their stat/channel is off.
+//StatId must be declared with DECLARE_CYCLE_STAT(..., STATGROUP_ShooterCombat) in the .cpp using it.
+#define SHOOTER_COMBAT_SCOPE(StatId) \
+	SCOPE_CYCLE_COUNTER(StatId); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(StatId, ShooterCombatChannel)
+
+//Same plus a per frame CSV timing column, for the few functions the match reports break frame time down by
+#define SHOOTER_COMBAT_CSV_SCOPE(StatId, CsvStat) \
+	SHOOTER_COMBAT_SCOPE(StatId); \
+	CSV_SCOPED_TIMING_STAT(ShooterCombat, CsvStat)
+
+namespace MyCombatStats
+{
+	UE5POINT5_SHOOTER_API FMyCombatCounters& GetCounters();
+
+	FORCEINLINE void AddTraces(int32 Count) { GetCounters().Traces += Count; INC_DWORD_STAT_BY(STAT_ShooterTraces, Count); CSV_CUSTOM_STAT(ShooterCombat, Traces, Count, ECsvCustomStatOp::Accumulate); }
+	FORCEINLINE void AddShotFired() { GetCounters().ShotsFired++; INC_DWORD_STAT(STAT_ShooterShotsFired); CSV_CUSTOM_STAT(ShooterCombat, Shots, 1, ECsvCustomStatOp::Accumulate); }
+	FORCEINLINE void AddEmitterSpawned() { GetCounters().EmittersSpawned++; INC_DWORD_STAT(STAT_ShooterEmittersSpawned); CSV_CUSTOM_STAT(ShooterCombat, EmittersSpawned, 1, ECsvCustomStatOp::Accumulate); }
+	FORCEINLINE void AddPooledEmitterMiss() { GetCounters().PooledEmitterMisses++; INC_DWORD_STAT(STAT_ShooterPooledEmitterMisses); CSV_CUSTOM_STAT(ShooterCombat, PooledEmitterMisses, 1, ECsvCustomStatOp::Accumulate); }
+	FORCEINLINE void AddPooledActorHit() { INC_DWORD_STAT(STAT_ShooterPooledActorHits); CSV_CUSTOM_STAT(ShooterCombat, PooledActorHits, 1, ECsvCustomStatOp::Accumulate); }
+	FORCEINLINE void AddPooledActorMiss() { INC_DWORD_STAT(STAT_ShooterPooledActorMisses); CSV_CUSTOM_STAT(ShooterCombat, PooledActorMisses, 1, ECsvCustomStatOp::Accumulate); }
+	FORCEINLINE void AddHits(int32 Count) { GetCounters().Hits += Count; }
+	FORCEINLINE void AddUltimateUsed() { GetCounters().UltimatesUsed++; }
+	FORCEINLINE void AddItemPickedUp() { GetCounters().ItemsPickedUp++; }
+	FORCEINLINE void AddItemInFocus() { INC_DWORD_STAT(STAT_ShooterItemsInFocus); CSV_CUSTOM_STAT(ShooterCombat, ItemsInFocus, 1, ECsvCustomStatOp::Accumulate); }
+	FORCEINLINE void AddOverlappedItems(int32 Count) { CSV_CUSTOM_STAT(ShooterCombat, OverlappedItems, Count, ECsvCustomStatOp::Accumulate); }
+	FORCEINLINE void AddSoundPlayed() { GetCounters().SoundsPlayed++; INC_DWORD_STAT(STAT_ShooterSoundsPlayed); }
+	FORCEINLINE void AddSoundCulled() { GetCounters().SoundsCulled++; INC_DWORD_STAT(STAT_ShooterSoundsCulled); }
+}
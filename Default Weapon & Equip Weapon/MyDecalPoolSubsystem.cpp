@@ -0,0 +1,179 @@
+#include "MyDecalPoolSubsystem.h"
+#include "Components/DecalComponent.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "MyCombatStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Decal Pool"), STAT_ShooterDecalPool, STATGROUP_ShooterCombat);
+
+void UMyDecalPoolSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	LLM_SCOPE_BYTAG(Shooter_CombatFX);
+	Super::Initialize(Collection);
+
+	DecalOwner = nullptr;
+	Decals.Init(nullptr, MaxDecals);
+	ExpireTimes.Init(0.f, MaxDecals);
+	SlotCells.Init(FIntVector::ZeroValue, MaxDecals);
+	CellCounts.Reserve(MaxDecals);
+	NextSlot = 0;
+	NumActive = 0;
+	Cycles = 0;
+}
+
+void UMyDecalPoolSubsystem::Deinitialize()
+{
+	Decals.Reset();
+	DecalOwner = nullptr; //Goes with the world
+	Super::Deinitialize();
+}
+
+bool UMyDecalPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UMyDecalPoolSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMyDecalPoolSubsystem, STATGROUP_Tickables);
+}
+
+int32 UMyDecalPoolSubsystem::GetNumDecalComponents() const
+{
+	int32 NumComponents = 0;
+	for (const UDecalComponent* Decal : Decals)
+	{
+		NumComponents += IsValid(Decal) && Decal->IsRegistered() ? 1 : 0;
+	}
+	return NumComponents;
+}
+
+uint64 UMyDecalPoolSubsystem::ConsumeCycles()
+{
+	const uint64 Consumed = Cycles;
+	Cycles = 0;
+	return Consumed;
+}
+
+FIntVector UMyDecalPoolSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+}
+
+UDecalComponent* UMyDecalPoolSubsystem::GetOrCreateDecal(int32 Slot)
+{
+	if (IsValid(Decals[Slot]))
+	{
+		return Decals[Slot];
+	}
+	LLM_SCOPE_BYTAG(Shooter_CombatFX);
+	if (!IsValid(DecalOwner))
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		DecalOwner = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+		DecalOwner->SetRootComponent(NewObject<USceneComponent>(DecalOwner));
+		DecalOwner->GetRootComponent()->RegisterComponent();
+	}
+
+	UDecalComponent* Decal = NewObject<UDecalComponent>(DecalOwner);
+	Decal->SetupAttachment(DecalOwner->GetRootComponent());
+	Decal->SetUsingAbsoluteLocation(true);
+	Decal->SetUsingAbsoluteRotation(true);
+	Decal->RegisterComponent();
+	Decals[Slot] = Decal;
+	return Decal;
+}
+
+void UMyDecalPoolSubsystem::FreeSlot(int32 Slot)
+{
+	ExpireTimes[Slot] = 0.f;
+	if (IsValid(Decals[Slot]))
+	{
+		Decals[Slot]->SetVisibility(false);
+	}
+	NumActive--;
+	if (int32* Count = CellCounts.Find(SlotCells[Slot]))
+	{
+		if (--(*Count) <= 0)
+		{
+			CellCounts.Remove(SlotCells[Slot]);
+		}
+	}
+}
+
+int32 UMyDecalPoolSubsystem::FindSlot(const FIntVector& Cell)
+{
+	//A full cell recycles its own oldest decal, so the rest of the world keeps its share of the budget
+	const int32* CellCount = CellCounts.Find(Cell);
+	if (CellCount && *CellCount >= MaxDecalsPerCell)
+	{
+		int32 OldestInCell = INDEX_NONE;
+		for (int32 Slot = 0; Slot < MaxDecals; Slot++)
+		{
+			if (ExpireTimes[Slot] > 0.f && SlotCells[Slot] == Cell && (OldestInCell == INDEX_NONE || ExpireTimes[Slot] < ExpireTimes[OldestInCell]))
+			{
+				OldestInCell = Slot;
+			}
+		}
+		if (OldestInCell != INDEX_NONE)
+		{
+			return OldestInCell;
+		}
+	}
+
+	const int32 Slot = NextSlot;
+	NextSlot = (NextSlot + 1) % MaxDecals;
+	return Slot;
+}
+
+void UMyDecalPoolSubsystem::PlaceDecal(UMaterialInterface* Material, const FVector& Size, const FVector& Location, const FVector& Normal)
+{
+	SHOOTER_COMBAT_SCOPE(STAT_ShooterDecalPool);
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	const FIntVector Cell = GetCell(Location);
+	const int32 Slot = FindSlot(Cell);
+	UDecalComponent* Decal = GetOrCreateDecal(Slot);
+	if (ExpireTimes[Slot] > 0.f)
+	{
+		FreeSlot(Slot); //Recycling the oldest
+	}
+
+	Decal->SetDecalMaterial(Material);
+	Decal->DecalSize = Size;
+	Decal->SetWorldLocationAndRotation(Location, (-Normal).Rotation());
+	Decal->SetFadeOut(DecalLifetime - DecalFadeDuration, DecalFadeDuration, false); //Faded by the renderer, restarts with the new render state
+	Decal->SetLifeSpan(0.f); //SetFadeOut also starts a timer that destroys the component, expiry is ours in Tick
+	Decal->SetVisibility(true);
+
+	ExpireTimes[Slot] = GetWorld()->GetTimeSeconds() + DecalLifetime;
+	SlotCells[Slot] = Cell;
+	CellCounts.FindOrAdd(Cell)++;
+	NumActive++;
+
+	Cycles += FPlatformTime::Cycles64() - StartCycles;
+}
+
+void UMyDecalPoolSubsystem::Tick(float DeltaTime)
+{
+	SHOOTER_COMBAT_SCOPE(STAT_ShooterDecalPool);
+	Super::Tick(DeltaTime);
+	if (NumActive == 0)
+	{
+		return;
+	}
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	//One pass over the expiry times hides every decal that finished fading
+	const float Now = GetWorld()->GetTimeSeconds();
+	for (int32 Slot = 0; Slot < MaxDecals; Slot++)
+	{
+		if (ExpireTimes[Slot] > 0.f && ExpireTimes[Slot] <= Now)
+		{
+			FreeSlot(Slot);
+		}
+	}
+
+	Cycles += FPlatformTime::Cycles64() - StartCycles;
+}
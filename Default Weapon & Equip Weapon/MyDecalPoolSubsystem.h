@@ -0,0 +1,56 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MyDecalPoolSubsystem.generated.h"
+
+class UDecalComponent;
+
+//Fixed set of impact decal components shared by every weapon.
+//Placing a decal reuses the oldest slot instead of spawning a component, and a small grid keeps one wall from taking the whole budget:
+//a cell that is full recycles its own oldest decal. Fading runs in the renderer (decal fade out), expiry is one pass in Tick.
+UCLASS()
+class UE5POINT5_SHOOTER_API UMyDecalPoolSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	void PlaceDecal(UMaterialInterface* Material, const FVector& Size, const FVector& Location, const FVector& Normal);
+
+	FORCEINLINE int32 GetNumActiveDecals() const { return NumActive; }
+	int32 GetNumDecalComponents() const; //Live, registered components, slots fill in on first use
+	//Game thread cycles spent placing and expiring decals since the last call
+	uint64 ConsumeCycles();
+
+private:
+	int32 FindSlot(const FIntVector& Cell);
+	void FreeSlot(int32 Slot);
+	UDecalComponent* GetOrCreateDecal(int32 Slot);
+	FIntVector GetCell(const FVector& Location) const;
+
+	static constexpr int32 MaxDecals = 256;
+	static constexpr int32 MaxDecalsPerCell = 12;
+	static constexpr float CellSize = 200.f;
+	static constexpr float DecalLifetime = 20.f;
+	static constexpr float DecalFadeDuration = 2.f;
+
+	UPROPERTY()
+	AActor* DecalOwner;
+	UPROPERTY()
+	TArray<UDecalComponent*> Decals; //Created on first use of a slot, never destroyed before the world
+
+	//Per slot, MaxDecals long
+	TArray<float> ExpireTimes; //0 for a free slot
+	TArray<FIntVector> SlotCells;
+	TMap<FIntVector, int32> CellCounts;
+
+	int32 NextSlot; //Ring cursor, the slot after the newest is the oldest
+	int32 NumActive;
+	uint64 Cycles;
+};
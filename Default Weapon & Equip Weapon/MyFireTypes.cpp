@@ -0,0 +1,49 @@
+#include "MyFireTypes.h"
+
+bool FMyFireShot::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	bool bMuzzleSuccess = true;
+	bool bDirectionSuccess = true;
+	MuzzleLocation.NetSerialize(Ar, Map, bMuzzleSuccess);
+	ShotDirection.NetSerialize(Ar, Map, bDirectionSuccess);
+	Ar << ClientTimeStamp;
+	Ar << ShotSequence;
+	Ar << PatternIndex;
+
+	bOutSuccess = bMuzzleSuccess && bDirectionSuccess;
+	return true;
+}
+
+void FMyFireScheduler::Start()
+{
+	if (!bTriggerHeld)
+	{
+		bTriggerHeld = true;
+		bJustPressed = true;
+	}
+}
+
+int32 FMyFireScheduler::Advance(float DeltaTime, TArray<float, TInlineAllocator<8>>& OutShotAlphas)
+{
+	OutShotAlphas.Reset();
+	if (!bTriggerHeld)
+	{
+		TimeToNextShot = FMath::Max(TimeToNextShot - DeltaTime, 0.f);
+		return 0;
+	}
+
+	//Time of the next shot, measured from the start of this frame
+	float ShotTime = TimeToNextShot;
+	if (bJustPressed)
+	{
+		ShotTime = DeltaTime + FMath::Max(TimeToNextShot - DeltaTime, 0.f);
+		bJustPressed = false;
+	}
+	while (ShotTime <= DeltaTime)
+	{
+		OutShotAlphas.Add(DeltaTime > 0.f ? ShotTime / DeltaTime : 1.f);
+		ShotTime += ShotInterval;
+	}
+	TimeToNextShot = ShotTime - DeltaTime;
+	return OutShotAlphas.Num();
+}
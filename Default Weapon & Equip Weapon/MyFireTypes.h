@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "MyFireTypes.generated.h"
+
+//One shot fired by the owning client, sent to the server inside a batched fire RPC.
+//Muzzle is quantized to 0.1 cm, direction to a 16 bit per axis unit vector.
+USTRUCT()
+struct FMyFireShot
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector_NetQuantize10 MuzzleLocation;
+
+	UPROPERTY()
+	FVector_NetQuantizeNormal ShotDirection;
+
+	UPROPERTY()
+	float ClientTimeStamp = 0.f; //Server world time as seen by the client when the shot was fired
+
+	UPROPERTY()
+	uint8 ShotSequence = 0; //Wraps around, compared with serial number arithmetic on the server
+
+	UPROPERTY()
+	uint8 PatternIndex = 0; //Entry of the weapon's spread table, ShotDirection is the aim before spread
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+//Serial number compare for the wrapping ShotSequence: true when Sequence is up to 127 shots after LastSequence
+FORCEINLINE bool IsNewerShotSequence(uint8 Sequence, uint8 LastSequence)
+{
+	return static_cast<int8>(Sequence - LastSequence) > 0;
+}
+
+template<>
+struct TStructOpsTypeTraits<FMyFireShot> : public TStructOpsTypeTraitsBase2<FMyFireShot>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+//One box the server keeps history for when rewinding a pawn for hit validation.
+//An empty bone name uses the actor transform (capsule center).
+USTRUCT(BlueprintType)
+struct FMyHitboxDefinition
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Hitbox)
+	FName BoneName;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Hitbox)
+	FVector Extent = FVector(20.f);
+};
+
+//Fire timing for automatic weapons, independent of frame rate.
+//Keeps the fractional time to the next shot across frames, so at any RPM and frame rate the number of shots over a hold is exact.
+//Advance reports every shot due inside the frame as a fraction of the frame (0 = start of the frame, 1 = now), for interpolating muzzle and time.
+struct FMyFireScheduler
+{
+	void Start();
+	void Stop() { bTriggerHeld = false; }
+	void SetInterval(float InShotInterval) { ShotInterval = FMath::Max(InShotInterval, KINDA_SMALL_NUMBER); }
+	int32 Advance(float DeltaTime, TArray<float, TInlineAllocator<8>>& OutShotAlphas);
+	bool IsTriggerHeld() const { return bTriggerHeld; }
+
+private:
+	float ShotInterval = 0.1f;
+	float TimeToNextShot = 0.f; //Can be negative only transiently inside Advance; keeps counting down while released so tapping can't beat the rate
+	bool bTriggerHeld = false;
+	bool bJustPressed = false; //Pressed between frames, the first shot goes out at the end of the next frame rather than interpolated back
+};
@@ -0,0 +1,324 @@
+#include "MyHitboxRewindSubsystem.h"
+#include "MyCharacter.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "CollisionQueryParams.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeExit.h"
+#include "MyCombatStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Hitbox Capture"), STAT_ShooterHitboxCapture, STATGROUP_ShooterCombat);
+DECLARE_CYCLE_STAT(TEXT("Rewind Line Trace"), STAT_ShooterRewindTrace, STATGROUP_ShooterCombat);
+
+void UMyHitboxRewindSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	//Everything is sized here, capture and rewind never allocate afterwards
+	SlotPawns.SetNum(MaxPawns);
+	ExtentX.SetNumZeroed(MaxPawns * MaxHitboxesPerPawn);
+	ExtentY.SetNumZeroed(MaxPawns * MaxHitboxesPerPawn);
+	ExtentZ.SetNumZeroed(MaxPawns * MaxHitboxesPerPawn);
+
+	const int32 NumBoxes = HistoryLength * MaxPawns * MaxHitboxesPerPawn;
+	CenterX.SetNumZeroed(NumBoxes);
+	CenterY.SetNumZeroed(NumBoxes);
+	CenterZ.SetNumZeroed(NumBoxes);
+	RotationX.SetNumZeroed(NumBoxes);
+	RotationY.SetNumZeroed(NumBoxes);
+	RotationZ.SetNumZeroed(NumBoxes);
+	RotationW.SetNumZeroed(NumBoxes);
+	FrameSlotBoxCount.SetNumZeroed(HistoryLength * MaxPawns);
+	FrameTimes.SetNumZeroed(HistoryLength);
+
+	HeadFrame = HistoryLength - 1; //First capture lands in frame 0
+	NumFrames = 0;
+	NumRewindQueries = 0;
+	RewindQueryCycles = 0;
+
+	UE_LOG(LogTemp, Log, TEXT("Hitbox rewind: %d frames, %d bytes per pawn, %d bytes total"),
+		HistoryLength, static_cast<int32>(GetBytesPerPawn()), static_cast<int32>(GetBytesPerPawn() * MaxPawns));
+}
+
+void UMyHitboxRewindSubsystem::Deinitialize()
+{
+	if (NumRewindQueries > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Hitbox rewind: %d queries, %.2f us per query"),
+			NumRewindQueries, FPlatformTime::ToMilliseconds64(RewindQueryCycles) * 1000.0 / NumRewindQueries);
+	}
+	Super::Deinitialize();
+}
+
+bool UMyHitboxRewindSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UMyHitboxRewindSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMyHitboxRewindSubsystem, STATGROUP_Tickables);
+}
+
+void UMyHitboxRewindSubsystem::Tick(float DeltaTime)
+{
+	SHOOTER_COMBAT_SCOPE(STAT_ShooterHitboxCapture);
+	Super::Tick(DeltaTime);
+
+	if (GetWorld()->GetNetMode() == NM_Client)
+	{
+		return; //Only the server validates hits
+	}
+	CaptureFrame(static_cast<float>(GetWorld()->GetTimeSeconds()));
+}
+
+void UMyHitboxRewindSubsystem::RegisterPawn(AMyCharacter* Pawn)
+{
+	if (!Pawn)
+	{
+		return;
+	}
+
+	int32 FreeSlot = INDEX_NONE;
+	for (int32 Slot = 0; Slot < MaxPawns; Slot++)
+	{
+		if (SlotPawns[Slot].Get() == Pawn)
+		{
+			return; //Already registered
+		}
+		if (FreeSlot == INDEX_NONE && !SlotPawns[Slot].IsValid())
+		{
+			FreeSlot = Slot;
+		}
+	}
+	if (FreeSlot == INDEX_NONE)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Hitbox rewind: no free slot for %s, it won't be lag compensated"), *Pawn->GetName());
+		return;
+	}
+
+	SlotPawns[FreeSlot] = Pawn;
+	for (int32 Frame = 0; Frame < HistoryLength; Frame++)
+	{
+		FrameSlotBoxCount[FrameSlotIndex(Frame, FreeSlot)] = 0; //Forget whoever used the slot before
+	}
+
+	//Extents don't change over time, so they are stored once per slot
+	const TArray<FMyHitboxDefinition>& Hitboxes = Pawn->GetRewindHitboxes();
+	for (int32 Box = 0; Box < MaxHitboxesPerPawn; Box++)
+	{
+		FVector Extent = FVector::ZeroVector;
+		if (Hitboxes.IsValidIndex(Box))
+		{
+			Extent = Hitboxes[Box].Extent;
+		}
+		else if (Box == 0 && Hitboxes.Num() == 0)
+		{
+			const UCapsuleComponent* Capsule = Pawn->GetCapsuleComponent();
+			Extent = FVector(Capsule->GetScaledCapsuleRadius(), Capsule->GetScaledCapsuleRadius(), Capsule->GetScaledCapsuleHalfHeight());
+		}
+		const int32 Index = FreeSlot * MaxHitboxesPerPawn + Box;
+		ExtentX[Index] = Extent.X;
+		ExtentY[Index] = Extent.Y;
+		ExtentZ[Index] = Extent.Z;
+	}
+}
+
+void UMyHitboxRewindSubsystem::UnregisterPawn(AMyCharacter* Pawn)
+{
+	for (int32 Slot = 0; Slot < MaxPawns; Slot++)
+	{
+		if (SlotPawns[Slot].Get() == Pawn)
+		{
+			SlotPawns[Slot] = nullptr;
+			for (int32 Frame = 0; Frame < HistoryLength; Frame++)
+			{
+				FrameSlotBoxCount[FrameSlotIndex(Frame, Slot)] = 0;
+			}
+			return;
+		}
+	}
+}
+
+void UMyHitboxRewindSubsystem::AddIgnoredPawns(FCollisionQueryParams& QueryParams) const
+{
+	for (const TWeakObjectPtr<AMyCharacter>& Pawn : SlotPawns)
+	{
+		if (Pawn.IsValid())
+		{
+			QueryParams.AddIgnoredActor(Pawn.Get());
+		}
+	}
+}
+
+void UMyHitboxRewindSubsystem::CaptureFrame(float Time)
+{
+	HeadFrame = (HeadFrame + 1) % HistoryLength;
+	NumFrames = FMath::Min(NumFrames + 1, HistoryLength);
+	FrameTimes[HeadFrame] = Time;
+
+	for (int32 Slot = 0; Slot < MaxPawns; Slot++)
+	{
+		uint8& BoxCount = FrameSlotBoxCount[FrameSlotIndex(HeadFrame, Slot)];
+		BoxCount = 0;
+
+		const AMyCharacter* Pawn = SlotPawns[Slot].Get();
+		if (!Pawn)
+		{
+			continue;
+		}
+
+		const TArray<FMyHitboxDefinition>& Hitboxes = Pawn->GetRewindHitboxes();
+		const int32 NumBoxes = Hitboxes.Num() > 0 ? FMath::Min(Hitboxes.Num(), MaxHitboxesPerPawn) : 1;
+		for (int32 Box = 0; Box < NumBoxes; Box++)
+		{
+			FTransform BoxTransform = Pawn->GetActorTransform();
+			if (Hitboxes.IsValidIndex(Box) && !Hitboxes[Box].BoneName.IsNone())
+			{
+				BoxTransform = Pawn->GetMesh()->GetSocketTransform(Hitboxes[Box].BoneName);
+			}
+
+			const FVector Center = BoxTransform.GetLocation();
+			const FQuat Rotation = BoxTransform.GetRotation();
+			const int32 Index = BoxIndex(HeadFrame, Slot, Box);
+			CenterX[Index] = Center.X;
+			CenterY[Index] = Center.Y;
+			CenterZ[Index] = Center.Z;
+			RotationX[Index] = Rotation.X;
+			RotationY[Index] = Rotation.Y;
+			RotationZ[Index] = Rotation.Z;
+			RotationW[Index] = Rotation.W;
+		}
+		BoxCount = static_cast<uint8>(NumBoxes);
+	}
+}
+
+bool UMyHitboxRewindSubsystem::RewindLineTrace(float Time, const FVector& Start, const FVector& End, const AMyCharacter* IgnorePawn, FMyRewindHit& OutHit)
+{
+	SHOOTER_COMBAT_SCOPE(STAT_ShooterRewindTrace);
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	ON_SCOPE_EXIT
+	{
+		RewindQueryCycles += FPlatformTime::Cycles64() - StartCycles;
+		NumRewindQueries++;
+	};
+
+	if (NumFrames == 0)
+	{
+		return false;
+	}
+
+	//Find the two frames around Time, walking back from the newest one
+	int32 OlderFrame = HeadFrame;
+	int32 NewerFrame = HeadFrame;
+	float Alpha = 0.f;
+	for (int32 Step = 0; Step < NumFrames; Step++)
+	{
+		const int32 Frame = (HeadFrame - Step + HistoryLength) % HistoryLength;
+		OlderFrame = Frame;
+		if (FrameTimes[Frame] <= Time)
+		{
+			if (Step > 0)
+			{
+				NewerFrame = (Frame + 1) % HistoryLength;
+				Alpha = (Time - FrameTimes[OlderFrame]) / FMath::Max(FrameTimes[NewerFrame] - FrameTimes[OlderFrame], KINDA_SMALL_NUMBER);
+			}
+			break;
+		}
+		NewerFrame = Frame; //Older than the whole history clamps to the oldest frame
+	}
+
+	FVector RayDirection = End - Start;
+	const float RayLength = RayDirection.Size();
+	if (RayLength < KINDA_SMALL_NUMBER)
+	{
+		return false;
+	}
+	RayDirection /= RayLength;
+
+	float BestDistance = RayLength;
+	bool bHit = false;
+
+	for (int32 Slot = 0; Slot < MaxPawns; Slot++)
+	{
+		const int32 NumBoxes = FMath::Min(FrameSlotBoxCount[FrameSlotIndex(OlderFrame, Slot)], FrameSlotBoxCount[FrameSlotIndex(NewerFrame, Slot)]);
+		if (NumBoxes == 0 || SlotPawns[Slot].Get() == IgnorePawn)
+		{
+			continue;
+		}
+
+		for (int32 Box = 0; Box < NumBoxes; Box++)
+		{
+			const int32 Old = BoxIndex(OlderFrame, Slot, Box);
+			const int32 New = BoxIndex(NewerFrame, Slot, Box);
+			const int32 ExtentIndex = Slot * MaxHitboxesPerPawn + Box;
+			const FVector Extent(ExtentX[ExtentIndex], ExtentY[ExtentIndex], ExtentZ[ExtentIndex]);
+
+			const FVector Center = FMath::Lerp(FVector(CenterX[Old], CenterY[Old], CenterZ[Old]), FVector(CenterX[New], CenterY[New], CenterZ[New]), Alpha);
+
+			//Cheap reject against the bounding sphere before the box test
+			const FVector ToCenter = Center - Start;
+			const float Along = FMath::Clamp(static_cast<float>(FVector::DotProduct(ToCenter, RayDirection)), 0.f, BestDistance);
+			if ((ToCenter - RayDirection * Along).SizeSquared() > Extent.SizeSquared())
+			{
+				continue;
+			}
+
+			const FQuat Rotation = FQuat::Slerp(
+				FQuat(RotationX[Old], RotationY[Old], RotationZ[Old], RotationW[Old]),
+				FQuat(RotationX[New], RotationY[New], RotationZ[New], RotationW[New]),
+				Alpha);
+
+			//Slab test in box space
+			const FVector LocalStart = Rotation.UnrotateVector(Start - Center);
+			const FVector LocalDirection = Rotation.UnrotateVector(RayDirection);
+			float EntryDistance = 0.f;
+			float ExitDistance = BestDistance;
+			int32 EntryAxis = INDEX_NONE;
+			bool bMissed = false;
+			for (int32 Axis = 0; Axis < 3 && !bMissed; Axis++)
+			{
+				const float Origin = LocalStart[Axis];
+				const float Direction = LocalDirection[Axis];
+				if (FMath::Abs(Direction) < KINDA_SMALL_NUMBER)
+				{
+					bMissed = FMath::Abs(Origin) > Extent[Axis];
+					continue;
+				}
+				float Near = (-Extent[Axis] - Origin) / Direction;
+				float Far = (Extent[Axis] - Origin) / Direction;
+				if (Near > Far)
+				{
+					Swap(Near, Far);
+				}
+				if (Near > EntryDistance)
+				{
+					EntryDistance = Near;
+					EntryAxis = Axis;
+				}
+				ExitDistance = FMath::Min(ExitDistance, Far);
+				bMissed = EntryDistance > ExitDistance;
+			}
+			if (bMissed)
+			{
+				continue;
+			}
+
+			FVector LocalNormal = -LocalDirection; //Ray started inside the box
+			if (EntryAxis != INDEX_NONE)
+			{
+				LocalNormal = FVector::ZeroVector;
+				LocalNormal[EntryAxis] = LocalDirection[EntryAxis] > 0.f ? -1.f : 1.f;
+			}
+
+			bHit = true;
+			BestDistance = EntryDistance;
+			OutHit.Pawn = SlotPawns[Slot].Get();
+			OutHit.HitboxIndex = Box;
+			OutHit.Distance = EntryDistance;
+			OutHit.Location = Start + RayDirection * EntryDistance;
+			OutHit.Normal = Rotation.RotateVector(LocalNormal);
+		}
+	}
+	return bHit;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MyHitboxRewindSubsystem.generated.h"
+
+class AMyCharacter;
+
+//Result of a trace against rewound hitboxes
+struct FMyRewindHit
+{
+	AMyCharacter* Pawn = nullptr;
+	int32 HitboxIndex = INDEX_NONE;
+	FVector Location = FVector::ZeroVector;
+	FVector Normal = FVector::ZeroVector;
+	float Distance = 0.f;
+};
+
+//Server side history of pawn hitboxes, used to validate shots against where targets were when the client fired.
+//Every server tick the hitbox transforms of all registered pawns are written into a fixed-size ring buffer.
+//Storage is struct-of-arrays, sized once in Initialize; capturing and rewinding never allocate.
+//Rewind queries interpolate between the two bracketing frames and trace the boxes analytically, real actors are never moved.
+UCLASS()
+class UE5POINT5_SHOOTER_API UMyHitboxRewindSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static constexpr int32 MaxPawns = 64;
+	static constexpr int32 MaxHitboxesPerPawn = 8;
+	static constexpr int32 HistoryLength = 32; //~0.5 s at 60 Hz server tick
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	void RegisterPawn(AMyCharacter* Pawn);
+	void UnregisterPawn(AMyCharacter* Pawn);
+
+	//Trace Start->End against hitboxes as they were at Time (server world time). Ignores IgnorePawn.
+	bool RewindLineTrace(float Time, const FVector& Start, const FVector& End, const AMyCharacter* IgnorePawn, FMyRewindHit& OutHit);
+
+	//Registered pawns are traced through history, so live traces validating shots should skip them
+	void AddIgnoredPawns(struct FCollisionQueryParams& QueryParams) const;
+
+	static constexpr SIZE_T GetBytesPerPawn()
+	{
+		return HistoryLength * MaxHitboxesPerPawn * (7 * sizeof(float)) //Center + rotation per box per frame
+			+ HistoryLength * sizeof(uint8) //Box count per frame
+			+ MaxHitboxesPerPawn * (3 * sizeof(float)); //Extents
+	}
+
+private:
+	void CaptureFrame(float Time);
+	FORCEINLINE int32 BoxIndex(int32 Frame, int32 Slot, int32 Box) const { return (Frame * MaxPawns + Slot) * MaxHitboxesPerPawn + Box; }
+	FORCEINLINE int32 FrameSlotIndex(int32 Frame, int32 Slot) const { return Frame * MaxPawns + Slot; }
+
+	//Per pawn slot
+	TArray<TWeakObjectPtr<AMyCharacter>> SlotPawns;
+	TArray<float> ExtentX;
+	TArray<float> ExtentY;
+	TArray<float> ExtentZ;
+
+	//Per frame, per slot, per box
+	TArray<float> CenterX;
+	TArray<float> CenterY;
+	TArray<float> CenterZ;
+	TArray<float> RotationX;
+	TArray<float> RotationY;
+	TArray<float> RotationZ;
+	TArray<float> RotationW;
+	TArray<uint8> FrameSlotBoxCount; //0 when the slot was empty in that frame
+
+	//Per frame
+	TArray<float> FrameTimes;
+	int32 HeadFrame;
+	int32 NumFrames;
+
+	//Query accounting, logged in Deinitialize
+	int32 NumRewindQueries;
+	uint64 RewindQueryCycles;
+};
@@ -0,0 +1,53 @@
+#include "MyImpactEffectsAsset.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "UObject/UObjectIterator.h"
+
+void UMyImpactEffectsAsset::PostLoad()
+{
+	Super::PostLoad();
+	BuildSurfaceTable();
+}
+
+#if WITH_EDITOR
+void UMyImpactEffectsAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	BuildSurfaceTable();
+}
+#endif
+
+void UMyImpactEffectsAsset::BuildSurfaceTable()
+{
+	for (FMyImpactEffect& Effect : SurfaceTable)
+	{
+		Effect = DefaultEffect;
+	}
+	bHasSurfaceEntries = false;
+	for (const FMyImpactEffect& Entry : Entries)
+	{
+		SurfaceTable[Entry.Surface] = Entry;
+		bHasSurfaceEntries |= Entry.Surface != SurfaceType_Default;
+	}
+}
+
+//Shooter.ImpactFX.Lookups [Count]
+//Times Count surface lookups against every loaded impact effects asset.
+static FAutoConsoleCommandWithArgs GImpactLookupsCommand(
+	TEXT("Shooter.ImpactFX.Lookups"),
+	TEXT("Shooter.ImpactFX.Lookups [Count]: time per hit impact effect lookups"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 Count = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1'000'000;
+		for (TObjectIterator<UMyImpactEffectsAsset> It; It; ++It)
+		{
+			int32 WithFX = 0;
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			for (int32 Lookup = 0; Lookup < Count; Lookup++)
+			{
+				WithFX += It->GetImpactEffect(static_cast<EPhysicalSurface>(Lookup % SurfaceType_Max)).ImpactFX != nullptr;
+			}
+			const double Nanoseconds = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1'000'000.0 / FMath::Max(Count, 1);
+			UE_LOG(LogTemp, Log, TEXT("%s: %.2f ns per lookup (%d with FX)"), *It->GetName(), Nanoseconds, WithFX);
+		}
+	}));
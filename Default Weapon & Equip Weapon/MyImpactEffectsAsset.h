@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "MyImpactEffectsAsset.generated.h"
+
+USTRUCT(BlueprintType)
+struct FMyImpactEffect
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Impact)
+	TEnumAsByte<EPhysicalSurface> Surface = SurfaceType_Default;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Impact)
+	class UParticleSystem* ImpactFX = nullptr;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Impact)
+	class USoundBase* ImpactSound = nullptr;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Impact)
+	class UMaterialInterface* DecalMaterial = nullptr;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Impact)
+	FVector DecalSize = FVector(5.f, 10.f, 10.f);
+};
+
+//Impact FX, sound and decal per physical surface.
+//Designers fill Entries; on load they are spread into a flat table indexed by EPhysicalSurface, surfaces without an entry get DefaultEffect.
+//A lookup is one array index returning a reference, no hashing and no allocation.
+UCLASS(BlueprintType)
+class UE5POINT5_SHOOTER_API UMyImpactEffectsAsset : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	FORCEINLINE const FMyImpactEffect& GetImpactEffect(EPhysicalSurface Surface) const { return SurfaceTable[Surface]; }
+	//False when every surface maps to the default, then traces don't have to return physical materials
+	FORCEINLINE bool NeedsPhysicalMaterial() const { return bHasSurfaceEntries; }
+
+private:
+	void BuildSurfaceTable();
+
+	UPROPERTY(EditAnywhere, Category = Impact)
+	FMyImpactEffect DefaultEffect;
+	UPROPERTY(EditAnywhere, Category = Impact)
+	TArray<FMyImpactEffect> Entries;
+
+	FMyImpactEffect SurfaceTable[SurfaceType_Max];
+	bool bHasSurfaceEntries = false;
+};
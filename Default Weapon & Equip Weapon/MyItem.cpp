@@ -3,9 +3,15 @@
 #include "Components/SphereComponent.h"
 #include "Components/WidgetComponent.h"
 #include "MyCharacter.h"
+#include "MyCombatStats.h"
+#include "MyCombatSimSubsystem.h"
 
-AMyItem::AMyItem()
+const FName AMyItem::WeaponWidgetName(TEXT("Weapon-Widget"));
+
+AMyItem::AMyItem(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
 {
+	LLM_SCOPE_BYTAG(Shooter_Items);
 	PrimaryActorTick.bCanEverTick = true;
 
 	StateOfItem = EStateOfItem::ESOI_NotEquipped;
@@ -18,8 +24,17 @@ AMyItem::AMyItem()
 	ItemBoxCollider->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 	ItemBoxCollider->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block);
 	
-	WeaponWidget = CreateDefaultSubobject<UWidgetComponent>(TEXT("Weapon-Widget"));
-	WeaponWidget->SetupAttachment(GetRootComponent());
+	//Widgets are cosmetic, a dedicated server or a combat simulation never creates them. The subobject is declared optional
+	//either way, so Blueprints saved in the editor load the same on those processes, their widget overrides just go unused.
+	if (IsRunningDedicatedServer() || UMyCombatSimSubsystem::IsCombatSimulation())
+	{
+		ObjectInitializer.DoNotCreateDefaultSubobject(WeaponWidgetName);
+	}
+	WeaponWidget = CreateOptionalDefaultSubobject<UWidgetComponent>(WeaponWidgetName);
+	if (WeaponWidget)
+	{
+		WeaponWidget->SetupAttachment(GetRootComponent());
+	}
 
 	SphereDetector = CreateDefaultSubobject<USphereComponent>(TEXT("Sphere-Detector"));
 	SphereDetector->SetupAttachment(GetRootComponent());
@@ -28,8 +43,9 @@ AMyItem::AMyItem()
 
 void AMyItem::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(Shooter_Items); //Widget components create their widgets here
 	Super::BeginPlay();
-	WeaponWidget->SetVisibility(false);
+	ShowWeaponWidget(false);
 	SphereDetector->OnComponentBeginOverlap.AddDynamic(this, &AMyItem::OnSphereOverlap);
 	SphereDetector->OnComponentEndOverlap.AddDynamic(this, &AMyItem::OnSphereEndOverlap);
 }
@@ -91,6 +107,22 @@ void AMyItem::SetItemProperties(EStateOfItem State)
 		ItemBoxCollider->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 		break;
 
+	case EStateOfItem::ESOI_Pooled:
+		//Set Mesh Properties
+		ItemSkeletalMesh->SetSimulatePhysics(false);
+		ItemSkeletalMesh->SetVisibility(false);
+		ItemSkeletalMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
+		ItemSkeletalMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		//Set Area Sphere Properties
+		SphereDetector->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
+		SphereDetector->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		//Set Collision Box Properties
+		ItemBoxCollider->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
+		ItemBoxCollider->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		//Set Widget Properties
+		ShowWeaponWidget(false);
+		break;
+
 	default:
 		break;
 	}
@@ -106,4 +138,24 @@ void AMyItem::SetStateOfItem(EStateOfItem State)
 {
 	StateOfItem = State;
 	SetItemProperties(State);
+}
+
+void AMyItem::OnAcquiredFromPool()
+{
+	SetStateOfItem(EStateOfItem::ESOI_NotEquipped);
+}
+
+void AMyItem::OnReturnedToPool()
+{
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	SetOwner(nullptr);
+	SetStateOfItem(EStateOfItem::ESOI_Pooled); //Bots and pickups only look at items that are not equipped
+}
+
+void AMyItem::ShowWeaponWidget(bool bVisible)
+{
+	if (WeaponWidget)
+	{
+		WeaponWidget->SetVisibility(bVisible);
+	}
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "MyActorPoolSubsystem.h"
 #include "MyItem.generated.h"
 
 
@@ -14,13 +15,14 @@ enum class EStateOfItem :uint8
 	ESOI_IsToBeEquipped UMETA(DisplayName = "Is To Be Equipped"),
 	ESOI_PickedUp UMETA(DisplayName = "PickedUp"),
 	ESOI_Equipped UMETA(DisplayName = "Equipped"),
-	ESOI_Falling UMETA(DisplayName = "Falling")
+	ESOI_Falling UMETA(DisplayName = "Falling"),
+	ESOI_Pooled UMETA(DisplayName = "Pooled")
 };
 
 UCLASS()
 
 
-class UE5POINT5_SHOOTER_API AMyItem : public AActor
+class UE5POINT5_SHOOTER_API AMyItem : public AActor, public IMyPooledActor
 {
 	GENERATED_BODY()
 	
@@ -40,13 +42,19 @@ private:
 	EStateOfItem StateOfItem;
 
 public:	
-	AMyItem();
+	AMyItem(const FObjectInitializer& ObjectInitializer);
+	static const FName WeaponWidgetName;
 	virtual void Tick(float DeltaTime) override;
-	FORCEINLINE UWidgetComponent* ReturnWeaponWidget() const { return WeaponWidget; }
+	FORCEINLINE UWidgetComponent* ReturnWeaponWidget() const { return WeaponWidget; } //Null on a dedicated server
 	FORCEINLINE UBoxComponent* ReturnItemBoxCollider() const { return ItemBoxCollider; }
 	FORCEINLINE USphereComponent* ReturnSphereDetector() const { return SphereDetector; }
 	FORCEINLINE EStateOfItem GetStateOfItem() const { return StateOfItem; }
 	void SetStateOfItem(EStateOfItem State);
+	void ShowWeaponWidget(bool bVisible);
+
+	//Pool reset hooks: a reused item comes back as a loose, not equipped pickup
+	virtual void OnAcquiredFromPool() override;
+	virtual void OnReturnedToPool() override;
 
 protected:
 	virtual void BeginPlay() override;
@@ -0,0 +1,64 @@
+#include "MyMontagePlayer.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimMontage.h"
+#include "Components/SkeletalMeshComponent.h"
+
+void FMyMontagePlayer::Initialize(USkeletalMeshComponent* InMesh)
+{
+	Mesh = InMesh;
+	CachedAnimInstance = InMesh ? InMesh->GetAnimInstance() : nullptr;
+	Sections.Reset();
+}
+
+UAnimInstance* FMyMontagePlayer::GetAnimInstance()
+{
+	if (!CachedAnimInstance.IsValid() && Mesh.IsValid())
+	{
+		CachedAnimInstance = Mesh->GetAnimInstance(); //Anim class changed or wasn't initialized yet
+	}
+	return CachedAnimInstance.Get();
+}
+
+const FMyMontagePlayer::FSectionEntry* FMyMontagePlayer::FindSection(UAnimMontage* Montage, FName SectionName)
+{
+	for (const FSectionEntry& Entry : Sections)
+	{
+		if (Entry.Montage.Get() == Montage && Entry.SectionName == SectionName)
+		{
+			return &Entry;
+		}
+	}
+
+	const int32 SectionIndex = Montage->GetSectionIndex(SectionName);
+	if (SectionIndex == INDEX_NONE)
+	{
+		return nullptr;
+	}
+	float StartTime = 0.f;
+	float EndTime = 0.f;
+	Montage->GetSectionStartAndEndTime(SectionIndex, StartTime, EndTime);
+	return &Sections.Add_GetRef({ Montage, SectionName, StartTime });
+}
+
+void FMyMontagePlayer::Play(UAnimMontage* Montage, FName SectionName)
+{
+	UAnimInstance* AnimInstance = GetAnimInstance();
+	if (!Montage || !AnimInstance)
+	{
+		return;
+	}
+	const FSectionEntry* Section = FindSection(Montage, SectionName);
+	const float StartTime = Section ? Section->StartTime : 0.f;
+
+	//Still playing and not blending out: rewind it, no new instance and no blend in
+	FAnimMontageInstance* MontageInstance = AnimInstance->GetActiveInstanceForMontage(Montage);
+	if (MontageInstance && MontageInstance->IsPlaying() && !MontageInstance->IsStopped())
+	{
+		MontageInstance->SetPosition(StartTime);
+		Restarts++;
+		return;
+	}
+
+	AnimInstance->Montage_Play(Montage, 1.f, EMontagePlayReturnType::MontageLength, StartTime);
+	InstancesStarted++;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UAnimInstance;
+class UAnimMontage;
+class USkeletalMeshComponent;
+
+//Montage playback for montages played over and over (weapon fire).
+//Holds on to the mesh's anim instance, resolves each montage section name once, and restarts a montage that is still playing
+//by moving its position back instead of starting a new montage instance.
+struct FMyMontagePlayer
+{
+	void Initialize(USkeletalMeshComponent* InMesh);
+	void Play(UAnimMontage* Montage, FName SectionName);
+
+	FORCEINLINE int64 GetInstancesStarted() const { return InstancesStarted; }
+	FORCEINLINE int64 GetRestarts() const { return Restarts; }
+
+private:
+	struct FSectionEntry
+	{
+		TWeakObjectPtr<UAnimMontage> Montage;
+		FName SectionName;
+		float StartTime;
+	};
+
+	UAnimInstance* GetAnimInstance();
+	const FSectionEntry* FindSection(UAnimMontage* Montage, FName SectionName);
+
+	TWeakObjectPtr<USkeletalMeshComponent> Mesh;
+	TWeakObjectPtr<UAnimInstance> CachedAnimInstance;
+	TArray<FSectionEntry, TInlineAllocator<4>> Sections; //A character only plays a handful of montage sections
+
+	int64 InstancesStarted = 0;
+	int64 Restarts = 0;
+};
@@ -0,0 +1,210 @@
+#include "MyProjectileSubsystem.h"
+#include "MyTraceBatch.h"
+#include "Engine/World.h"
+#include "Components/SphereComponent.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "MyCombatStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Projectile Tick"), STAT_ShooterProjectileTick, STATGROUP_ShooterCombat);
+
+void UMyProjectileSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	static constexpr int32 ExpectedProjectiles = 256; //Storage only grows past this, removal never shrinks it
+	PositionX.Reserve(ExpectedProjectiles);
+	PositionY.Reserve(ExpectedProjectiles);
+	PositionZ.Reserve(ExpectedProjectiles);
+	VelocityX.Reserve(ExpectedProjectiles);
+	VelocityY.Reserve(ExpectedProjectiles);
+	VelocityZ.Reserve(ExpectedProjectiles);
+	GravityZ.Reserve(ExpectedProjectiles);
+	TimeLeft.Reserve(ExpectedProjectiles);
+	Radius.Reserve(ExpectedProjectiles);
+	Instigators.Reserve(ExpectedProjectiles);
+
+	TickCycles = 0;
+	ProjectileTicks = 0;
+}
+
+void UMyProjectileSubsystem::Deinitialize()
+{
+	if (ProjectileTicks > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Projectiles: %lld projectile ticks, %.3f us per projectile"),
+			ProjectileTicks, FPlatformTime::ToMilliseconds64(TickCycles) * 1000.0 / ProjectileTicks);
+	}
+	Super::Deinitialize();
+}
+
+bool UMyProjectileSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UMyProjectileSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMyProjectileSubsystem, STATGROUP_Tickables);
+}
+
+void UMyProjectileSubsystem::LaunchProjectile(const FVector& Location, const FVector& Velocity, AActor* Instigator, float CollisionRadius, float Lifetime, float GravityScale)
+{
+	PositionX.Add(Location.X);
+	PositionY.Add(Location.Y);
+	PositionZ.Add(Location.Z);
+	VelocityX.Add(Velocity.X);
+	VelocityY.Add(Velocity.Y);
+	VelocityZ.Add(Velocity.Z);
+	GravityZ.Add(GetWorld()->GetGravityZ() * GravityScale);
+	TimeLeft.Add(Lifetime);
+	Radius.Add(CollisionRadius);
+	Instigators.Add(Instigator);
+}
+
+void UMyProjectileSubsystem::RemoveProjectile(int32 Index)
+{
+	PositionX.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	PositionY.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	PositionZ.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	VelocityX.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	VelocityY.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	VelocityZ.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	GravityZ.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	TimeLeft.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Radius.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Instigators.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
+
+void UMyProjectileSubsystem::Integrate(float DeltaTime)
+{
+	//Each loop walks contiguous floats with no branches, so the compiler can vectorize them
+	const int32 Num = PositionX.Num();
+	float* RESTRICT VZ = VelocityZ.GetData();
+	const float* RESTRICT GZ = GravityZ.GetData();
+	for (int32 Index = 0; Index < Num; Index++)
+	{
+		VZ[Index] += GZ[Index] * DeltaTime;
+	}
+
+	float* RESTRICT PX = PositionX.GetData();
+	float* RESTRICT PY = PositionY.GetData();
+	float* RESTRICT PZ = PositionZ.GetData();
+	const float* RESTRICT VX = VelocityX.GetData();
+	const float* RESTRICT VY = VelocityY.GetData();
+	for (int32 Index = 0; Index < Num; Index++)
+	{
+		PX[Index] += VX[Index] * DeltaTime;
+		PY[Index] += VY[Index] * DeltaTime;
+		PZ[Index] += VZ[Index] * DeltaTime;
+	}
+
+	float* RESTRICT Life = TimeLeft.GetData();
+	for (int32 Index = 0; Index < Num; Index++)
+	{
+		Life[Index] -= DeltaTime;
+	}
+}
+
+void UMyProjectileSubsystem::Tick(float DeltaTime)
+{
+	SHOOTER_COMBAT_SCOPE(STAT_ShooterProjectileTick);
+	Super::Tick(DeltaTime);
+
+	const int32 Num = PositionX.Num();
+	if (Num == 0)
+	{
+		return;
+	}
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	SweepStarts.SetNumUninitialized(Num, EAllowShrinking::No);
+	SweepEnds.SetNumUninitialized(Num, EAllowShrinking::No);
+	SweepHits.SetNum(Num, EAllowShrinking::No);
+	SweepIgnoredActors.SetNumUninitialized(Num, EAllowShrinking::No);
+	for (int32 Index = 0; Index < Num; Index++)
+	{
+		SweepStarts[Index] = FVector(PositionX[Index], PositionY[Index], PositionZ[Index]);
+		SweepIgnoredActors[Index] = Instigators[Index].Get();
+	}
+
+	Integrate(DeltaTime);
+
+	for (int32 Index = 0; Index < Num; Index++)
+	{
+		SweepEnds[Index] = FVector(PositionX[Index], PositionY[Index], PositionZ[Index]);
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(MyProjectileSweep));
+	MyTraceBatch::SphereSweeps(GetWorld(), SweepStarts, SweepEnds, Radius, SweepHits, ECollisionChannel::ECC_Visibility, QueryParams, SweepIgnoredActors);
+
+	//Walk backwards so swap-removal doesn't skip anything
+	for (int32 Index = Num - 1; Index >= 0; Index--)
+	{
+		const FHitResult& Hit = SweepHits[Index];
+		if (Hit.bBlockingHit)
+		{
+			FMyProjectileImpact Impact;
+			Impact.Location = Hit.Location;
+			Impact.Normal = Hit.ImpactNormal;
+			Impact.Velocity = FVector(VelocityX[Index], VelocityY[Index], VelocityZ[Index]);
+			Impact.HitActor = Hit.GetActor();
+			Impact.Instigator = Instigators[Index];
+			RemoveProjectile(Index);
+			OnProjectileImpact.Broadcast(Impact);
+		}
+		else if (TimeLeft[Index] <= 0.f)
+		{
+			RemoveProjectile(Index);
+		}
+	}
+
+	TickCycles += FPlatformTime::Cycles64() - StartCycles;
+	ProjectileTicks += Num;
+}
+
+//Shooter.Projectiles.Stress <Count> [Actors]
+//Launches Count long lived projectiles from the world origin. With Actors, spawns one actor with a sphere and a
+//UProjectileMovementComponent per projectile instead, as the baseline to compare against with stat game / Insights.
+static FAutoConsoleCommandWithWorldAndArgs GProjectileStressCommand(
+	TEXT("Shooter.Projectiles.Stress"),
+	TEXT("Shooter.Projectiles.Stress <Count> [Actors]: launch Count test projectiles, optionally as one actor each"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World)
+		{
+			return;
+		}
+		const int32 Count = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 2000;
+		const bool bActors = Args.Num() > 1 && Args[1].Equals(TEXT("Actors"), ESearchCase::IgnoreCase);
+
+		FRandomStream Random(Count);
+		UMyProjectileSubsystem* Projectiles = World->GetSubsystem<UMyProjectileSubsystem>();
+		for (int32 Index = 0; Index < Count; Index++)
+		{
+			const FVector Location(0.f, 0.f, 500.f);
+			const FVector Velocity = Random.VRand() * 1500.f;
+			if (!bActors && Projectiles)
+			{
+				Projectiles->LaunchProjectile(Location, Velocity, nullptr, 10.f, 10.f);
+			}
+			else if (bActors)
+			{
+				AActor* ProjectileActor = World->SpawnActor<AActor>(AActor::StaticClass(), Location, Velocity.Rotation());
+				USphereComponent* Sphere = NewObject<USphereComponent>(ProjectileActor);
+				Sphere->InitSphereRadius(10.f);
+				Sphere->SetCollisionProfileName(TEXT("BlockAllDynamic"));
+				ProjectileActor->SetRootComponent(Sphere);
+				Sphere->RegisterComponent();
+				UProjectileMovementComponent* Movement = NewObject<UProjectileMovementComponent>(ProjectileActor);
+				Movement->InitialSpeed = 1500.f;
+				Movement->ProjectileGravityScale = 0.f;
+				Movement->SetUpdatedComponent(Sphere);
+				Movement->RegisterComponent();
+				Movement->Velocity = Velocity;
+				ProjectileActor->SetLifeSpan(10.f);
+			}
+		}
+		UE_LOG(LogTemp, Log, TEXT("Projectiles: launched %d %s"), Count, bActors ? TEXT("actors") : TEXT("pooled projectiles"));
+	}));
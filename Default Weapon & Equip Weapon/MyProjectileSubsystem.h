@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MyProjectileSubsystem.generated.h"
+
+struct FMyProjectileImpact
+{
+	FVector Location = FVector::ZeroVector;
+	FVector Normal = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+	TWeakObjectPtr<AActor> HitActor;
+	TWeakObjectPtr<AActor> Instigator;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnMyProjectileImpact, const FMyProjectileImpact&);
+
+//Simulates every live projectile (ultimate rockets) without an actor per projectile.
+//State is kept as struct-of-arrays and integrated in one pass per frame, then all sweeps for the frame go out as one batch.
+//Impacts are broadcast through OnProjectileImpact; whoever launched the projectile reacts to it (FX, damage).
+UCLASS()
+class UE5POINT5_SHOOTER_API UMyProjectileSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	void LaunchProjectile(const FVector& Location, const FVector& Velocity, AActor* Instigator, float CollisionRadius, float Lifetime, float GravityScale = 0.f);
+	FORCEINLINE int32 GetNumProjectiles() const { return PositionX.Num(); }
+
+	FOnMyProjectileImpact OnProjectileImpact;
+
+private:
+	void Integrate(float DeltaTime);
+	void RemoveProjectile(int32 Index);
+
+	//One entry per live projectile, always the same length. Removal swaps with the last entry.
+	TArray<float> PositionX;
+	TArray<float> PositionY;
+	TArray<float> PositionZ;
+	TArray<float> VelocityX;
+	TArray<float> VelocityY;
+	TArray<float> VelocityZ;
+	TArray<float> GravityZ;
+	TArray<float> TimeLeft;
+	TArray<float> Radius;
+	TArray<TWeakObjectPtr<AActor>> Instigators;
+
+	//Per frame scratch, reused so a steady projectile count doesn't allocate
+	TArray<FVector> SweepStarts;
+	TArray<FVector> SweepEnds;
+	TArray<FHitResult> SweepHits;
+	TArray<const AActor*> SweepIgnoredActors;
+
+	//Tick accounting, logged in Deinitialize
+	uint64 TickCycles;
+	int64 ProjectileTicks;
+};
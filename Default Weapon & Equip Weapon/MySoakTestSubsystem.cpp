@@ -0,0 +1,472 @@
+#include "MySoakTestSubsystem.h"
+#include "MyCharacter.h"
+#include "MyWeapon.h"
+#include "MyBotController.h"
+#include "MyDecalPoolSubsystem.h"
+#include "MyActorPoolSubsystem.h"
+#include "GameFramework/PlayerStart.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/FileManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+UMySoakTestSubsystem::UMySoakTestSubsystem()
+{
+	//Defaults for the stock Blueprint setup, override per project in DefaultGame.ini
+	LLMBudgets.Emplace(TEXT("Shooter/Character"), 1.f, 0.5f, 0.f);
+	LLMBudgets.Emplace(TEXT("Shooter/Items"), 0.5f, 0.25f, 0.25f);
+	LLMBudgets.Emplace(TEXT("Shooter/Weapons"), 0.5f, 0.1f, 0.1f);
+	LLMBudgets.Emplace(TEXT("Shooter/CombatFX"), 16.f, 0.5f, 0.f);
+	LLMBudgets.Emplace(TEXT("Shooter/CombatAudio"), 2.f, 0.1f, 0.f);
+
+	Scenarios.Emplace(TEXT("Bots64"), 64, 0, 0.f, 12.f, 4.f); //64 bots fighting
+	Scenarios.Emplace(TEXT("Pickups1000"), 16, 1000, 0.f, 10.f, 6.f, 2000.f); //Bots walking through a field of pickups, packed inside their wander radius
+	Scenarios.Emplace(TEXT("Ultimates20"), 20, 0, 10.f, 14.f, 6.f); //20 ultimates at once, every 10 seconds
+
+	Scenario = nullptr;
+	bRunning = false;
+	bScenarioMeasuring = false;
+}
+
+bool UMySoakTestSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	int32 RequestedBots = 0;
+	FString RequestedScenario;
+	return Super::ShouldCreateSubsystem(Outer) &&
+		((FParse::Value(FCommandLine::Get(), TEXT("SoakBots="), RequestedBots) && RequestedBots > 0) || FParse::Value(FCommandLine::Get(), TEXT("SoakScenario="), RequestedScenario));
+}
+
+bool UMySoakTestSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UMySoakTestSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMySoakTestSubsystem, STATGROUP_Tickables);
+}
+
+void UMySoakTestSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	NumBots = 0;
+	NumWeapons = 0;
+	Seed = 1;
+	DurationSamples = 0;
+	SampleInterval = 60.f;
+	const TCHAR* CommandLine = FCommandLine::Get();
+	FParse::Value(CommandLine, TEXT("SoakBots="), NumBots);
+	FParse::Value(CommandLine, TEXT("SoakWeapons="), NumWeapons);
+	FParse::Value(CommandLine, TEXT("SoakSeed="), Seed);
+	FParse::Value(CommandLine, TEXT("SoakMinutes="), DurationSamples);
+	FParse::Value(CommandLine, TEXT("SoakInterval="), SampleInterval);
+	SampleInterval = FMath::Max(SampleInterval, 1.f);
+	bCheckLLMBudgets = FParse::Param(CommandLine, TEXT("SoakLLMBudgets"));
+
+	Scenario = nullptr;
+	FString ScenarioName;
+	if (FParse::Value(CommandLine, TEXT("SoakScenario="), ScenarioName))
+	{
+		Scenario = Scenarios.FindByPredicate([&ScenarioName](const FMySoakScenarioBudget& Candidate) { return Candidate.Name.Equals(ScenarioName, ESearchCase::IgnoreCase); });
+		if (!Scenario)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Soak: unknown scenario %s"), *ScenarioName);
+			FPlatformMisc::RequestExitWithStatus(false, 1);
+			return;
+		}
+		NumBots = Scenario->Bots;
+		NumWeapons = Scenario->Weapons;
+		DurationSamples = 0; //The scenario decides when to quit
+	}
+
+	FString ClassPath;
+	if (FParse::Value(CommandLine, TEXT("SoakBotClass="), ClassPath))
+	{
+		BotCharacterClass = TSoftClassPtr<AMyCharacter>(FSoftObjectPath(ClassPath));
+	}
+	if (FParse::Value(CommandLine, TEXT("SoakWeaponClass="), ClassPath))
+	{
+		PickupWeaponClass = TSoftClassPtr<AMyWeapon>(FSoftObjectPath(ClassPath));
+	}
+
+	//Spawn everything around the first player start
+	FVector Center = FVector::ZeroVector;
+	for (TActorIterator<APlayerStart> It(&InWorld); It; ++It)
+	{
+		Center = It->GetActorLocation();
+		break;
+	}
+
+	ActorSpawnedHandle = InWorld.AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UMySoakTestSubsystem::OnActorSpawned));
+
+	const bool bWeaponsSpawned = SpawnWeapons(Center);
+	const bool bBotsSpawned = SpawnBots(Center);
+	if (Scenario && (!bWeaponsSpawned || !bBotsSpawned))
+	{
+		//Native bots have no mesh or muzzle and no weapons means an empty field, either would measure a world without the work
+		UE_LOG(LogTemp, Error, TEXT("Soak: scenario %s needs BotCharacterClass%s set to a loadable Blueprint"),
+			*Scenario->Name, NumWeapons > 0 ? TEXT(" and PickupWeaponClass") : TEXT(""));
+		FPlatformMisc::RequestExitWithStatus(false, 1);
+		return;
+	}
+
+	CsvPath = FPaths::ProfilingDir() / TEXT("Soak") / FString::Printf(TEXT("Soak_%dBots_%s.csv"), NumBots, *FDateTime::Now().ToString());
+	const FString Header = TEXT("Sample,Seconds,Frames,AvgFrameMs,MaxFrameMs,Traces,ShotsFired,EmittersSpawned,ActorsSpawned,UltimatesUsed,ItemsPickedUp,SoundsPlayed,SoundsCulled,PooledEmitterMisses,Decals,DecalComponents,DecalMs,UsedPhysicalMB\n");
+	FFileHelper::SaveStringToFile(Header, *CsvPath);
+	UE_LOG(LogTemp, Log, TEXT("Soak: %d bots, %d weapons, seed %d, writing %s"), NumBots, NumWeapons, Seed, *CsvPath);
+
+	//Tags the CSV profiler capture (-csvprofile) so match reports can tell runs apart
+	CSV_METADATA(TEXT("SoakBots"), *FString::FromInt(NumBots));
+	CSV_METADATA(TEXT("SoakWeapons"), *FString::FromInt(NumWeapons));
+	CSV_METADATA(TEXT("SoakSeed"), *FString::FromInt(Seed));
+	CSV_METADATA(TEXT("Map"), *InWorld.GetMapName());
+
+	LastCounters = MyCombatStats::GetCounters();
+	LastFrameSeconds = 0.0;
+	SampleStartSeconds = FPlatformTime::Seconds();
+	SampleFrames = 0;
+	SampleFrameSecondsTotal = 0.0;
+	SampleFrameSecondsMax = 0.0;
+	SampleActorsSpawned = 0;
+	SampleIndex = 0;
+	bRunning = true;
+
+	if (Scenario)
+	{
+		StartScenario(InWorld);
+	}
+}
+
+void UMySoakTestSubsystem::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+		if (StartPhysicsMarker.IsTickFunctionRegistered())
+		{
+			World->StartPhysicsTickFunction.RemovePrerequisite(this, StartPhysicsMarker);
+			StartPhysicsMarker.UnRegisterTickFunction();
+			EndPhysicsMarker.UnRegisterTickFunction();
+		}
+	}
+	FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+	FWorldDelegates::OnWorldPostActorTick.Remove(WorldPostActorTickHandle);
+	Super::Deinitialize();
+}
+
+bool UMySoakTestSubsystem::SpawnBots(const FVector& Center)
+{
+	if (BotCharacterClass.IsNull() && Scenario)
+	{
+		return false; //Scenarios measure the real character setup, not the native fallback
+	}
+	UClass* BotClass = BotCharacterClass.IsNull() ? AMyCharacter::StaticClass() : BotCharacterClass.LoadSynchronous();
+	if (!BotClass)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Soak: bot class %s failed to load"), *BotCharacterClass.ToString());
+		return false;
+	}
+
+	FRandomStream Random(Seed);
+	for (int32 BotIndex = 0; BotIndex < NumBots; BotIndex++)
+	{
+		//Ring layout so bots start apart but within engage range of each other
+		const float Angle = 2.f * PI * BotIndex / NumBots;
+		const float Radius = 300.f + 50.f * NumBots;
+		const FVector Location = Center + FVector(FMath::Cos(Angle) * Radius, FMath::Sin(Angle) * Radius, 100.f);
+		const FTransform SpawnTransform(FRotator(0.f, Random.FRandRange(-180.f, 180.f), 0.f), Location);
+
+		AMyCharacter* Bot = GetWorld()->SpawnActorDeferred<AMyCharacter>(BotClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+		if (!Bot)
+		{
+			continue;
+		}
+		Bot->AutoPossessPlayer = EAutoReceiveInput::Disabled;
+		Bot->AutoPossessAI = EAutoPossessAI::Disabled; //Possessed below, OnPossess draws the bot's timers from its seed
+		Bot->FinishSpawning(SpawnTransform);
+
+		FActorSpawnParameters ControllerParams;
+		ControllerParams.Instigator = Bot;
+		ControllerParams.OverrideLevel = Bot->GetLevel();
+		ControllerParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		if (AMyBotController* BotController = GetWorld()->SpawnActor<AMyBotController>(AMyBotController::StaticClass(), Bot->GetActorLocation(), Bot->GetActorRotation(), ControllerParams))
+		{
+			BotController->SetRandomSeed(Seed * 7919 + BotIndex);
+			BotController->Possess(Bot);
+		}
+	}
+	return true;
+}
+
+bool UMySoakTestSubsystem::SpawnWeapons(const FVector& Center)
+{
+	if (NumWeapons <= 0)
+	{
+		return true;
+	}
+	UClass* WeaponClass = PickupWeaponClass.IsNull() ? nullptr : PickupWeaponClass.LoadSynchronous();
+	if (!WeaponClass)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Soak: pickup weapon class %s not set or failed to load, skipping %d weapons"), *PickupWeaponClass.ToString(), NumWeapons);
+		return false;
+	}
+
+	UMyActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UMyActorPoolSubsystem>();
+	FRandomStream Random(Seed + 1);
+	const float Extent = Scenario && Scenario->WeaponExtent > 0.f ? Scenario->WeaponExtent : 500.f + 10.f * NumWeapons;
+	for (int32 WeaponIndex = 0; WeaponIndex < NumWeapons; WeaponIndex++)
+	{
+		const FVector Location = Center + FVector(Random.FRandRange(-Extent, Extent), Random.FRandRange(-Extent, Extent), 50.f);
+		AMyWeapon* Weapon = Pool ? Pool->Acquire<AMyWeapon>(WeaponClass, FTransform(Location)) : GetWorld()->SpawnActor<AMyWeapon>(WeaponClass, Location, FRotator::ZeroRotator);
+		if (Weapon)
+		{
+			Weapon->SetStateOfItem(EStateOfItem::ESOI_NotEquipped);
+		}
+	}
+	return true;
+}
+
+void UMySoakTestSubsystem::OnActorSpawned(AActor* Actor)
+{
+	SampleActorsSpawned++;
+}
+
+void UMySoakTestSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	if (!bRunning)
+	{
+		return;
+	}
+
+	//Wall clock frame time, DeltaTime may be clamped or fixed
+	const double NowSeconds = FPlatformTime::Seconds();
+	if (LastFrameSeconds > 0.0)
+	{
+		const double FrameSeconds = NowSeconds - LastFrameSeconds;
+		SampleFrameSecondsTotal += FrameSeconds;
+		SampleFrameSecondsMax = FMath::Max(SampleFrameSecondsMax, FrameSeconds);
+		SampleFrames++;
+	}
+	LastFrameSeconds = NowSeconds;
+
+	if (Scenario)
+	{
+		TickScenario(NowSeconds);
+		if (!bRunning)
+		{
+			return;
+		}
+	}
+	if (NowSeconds - SampleStartSeconds >= SampleInterval)
+	{
+		WriteSample();
+		if (bCheckLLMBudgets && !CheckLLMBudgets())
+		{
+			bRunning = false;
+			FPlatformMisc::RequestExitWithStatus(false, 1);
+			return;
+		}
+		if (DurationSamples > 0 && SampleIndex >= DurationSamples)
+		{
+			UE_LOG(LogTemp, Log, TEXT("Soak: finished %d samples, results in %s"), SampleIndex, *CsvPath);
+			bRunning = false;
+			FPlatformMisc::RequestExit(false);
+		}
+	}
+}
+
+void UMySoakTestSubsystem::WriteSample()
+{
+	const FMyCombatCounters& Counters = MyCombatStats::GetCounters();
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	const double SampleSeconds = FPlatformTime::Seconds() - SampleStartSeconds;
+	UMyDecalPoolSubsystem* DecalPool = GetWorld()->GetSubsystem<UMyDecalPoolSubsystem>();
+
+	const FString Row = FString::Printf(TEXT("%d,%.1f,%d,%.3f,%.3f,%lld,%lld,%lld,%lld,%lld,%lld,%lld,%lld,%lld,%d,%d,%.3f,%.1f\n"),
+		SampleIndex,
+		SampleSeconds,
+		SampleFrames,
+		SampleFrames > 0 ? SampleFrameSecondsTotal * 1000.0 / SampleFrames : 0.0,
+		SampleFrameSecondsMax * 1000.0,
+		Counters.Traces - LastCounters.Traces,
+		Counters.ShotsFired - LastCounters.ShotsFired,
+		Counters.EmittersSpawned - LastCounters.EmittersSpawned,
+		SampleActorsSpawned,
+		Counters.UltimatesUsed - LastCounters.UltimatesUsed,
+		Counters.ItemsPickedUp - LastCounters.ItemsPickedUp,
+		Counters.SoundsPlayed - LastCounters.SoundsPlayed,
+		Counters.SoundsCulled - LastCounters.SoundsCulled,
+		Counters.PooledEmitterMisses - LastCounters.PooledEmitterMisses,
+		DecalPool ? DecalPool->GetNumActiveDecals() : 0,
+		DecalPool ? DecalPool->GetNumDecalComponents() : 0,
+		DecalPool ? FPlatformTime::ToMilliseconds64(DecalPool->ConsumeCycles()) : 0.0,
+		MemoryStats.UsedPhysical / (1024.0 * 1024.0));
+	FFileHelper::SaveStringToFile(Row, *CsvPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+
+	LastCounters = Counters;
+	SampleStartSeconds = FPlatformTime::Seconds();
+	SampleFrames = 0;
+	SampleFrameSecondsTotal = 0.0;
+	SampleFrameSecondsMax = 0.0;
+	SampleActorsSpawned = 0;
+	SampleIndex++;
+}
+
+bool UMySoakTestSubsystem::CheckLLMBudgets() const
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	if (!FLowLevelMemTracker::IsEnabled())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Soak: -SoakLLMBudgets needs -llm, nothing is tracked"));
+		return false;
+	}
+
+	bool bWithinBudget = true;
+	for (const FMySoakLLMBudget& Budget : LLMBudgets)
+	{
+		const double UsedMB = FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, Budget.Tag, ELLMTagSet::None) / (1024.0 * 1024.0);
+		const double BudgetMB = Budget.BaseMB + Budget.PerBotMB * NumBots + Budget.PerWeaponMB * NumWeapons;
+		if (UsedMB > BudgetMB)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Soak: %s uses %.2f MB, budget %.2f MB for %d bots and %d weapons"), *Budget.Tag.ToString(), UsedMB, BudgetMB, NumBots, NumWeapons);
+			bWithinBudget = false;
+		}
+	}
+	return bWithinBudget;
+#else
+	UE_LOG(LogTemp, Error, TEXT("Soak: -SoakLLMBudgets needs a build with LLM compiled in"));
+	return false;
+#endif
+}
+
+void UMySoakTestSubsystem::StartScenario(UWorld& InWorld)
+{
+	ScenarioWarmup = 5.f;
+	ScenarioSeconds = 60.f;
+	FParse::Value(FCommandLine::Get(), TEXT("SoakScenarioWarmup="), ScenarioWarmup);
+	FParse::Value(FCommandLine::Get(), TEXT("SoakScenarioSeconds="), ScenarioSeconds);
+	ScenarioStartSeconds = FPlatformTime::Seconds();
+	NextUltimateSeconds = ScenarioStartSeconds + ScenarioWarmup;
+	bScenarioMeasuring = false;
+	WorldTickStartCycles = 0;
+	PhysicsStartCycles = 0;
+	const int32 ExpectedFrames = FMath::CeilToInt(ScenarioSeconds * 120.f);
+	GameThreadMs.Reset(ExpectedFrames);
+	DuringPhysicsMs.Reset(ExpectedFrames);
+
+	WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UMySoakTestSubsystem::OnWorldTickStart);
+	WorldPostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UMySoakTestSubsystem::OnWorldPostActorTick);
+
+	//During-physics window: from just before the world kicks off physics until its end of physics wait is done. Game thread
+	//ticks in TG_DuringPhysics run inside it, so this is frame time spent while physics runs, not the physics scene's own cost.
+	StartPhysicsMarker.Soak = this;
+	StartPhysicsMarker.bStartOfPhysics = true;
+	StartPhysicsMarker.TickGroup = TG_StartPhysics;
+	StartPhysicsMarker.bCanEverTick = true;
+	StartPhysicsMarker.RegisterTickFunction(InWorld.PersistentLevel);
+	InWorld.StartPhysicsTickFunction.AddPrerequisite(this, StartPhysicsMarker);
+
+	EndPhysicsMarker.Soak = this;
+	EndPhysicsMarker.bStartOfPhysics = false;
+	EndPhysicsMarker.TickGroup = TG_EndPhysics;
+	EndPhysicsMarker.bCanEverTick = true;
+	EndPhysicsMarker.RegisterTickFunction(InWorld.PersistentLevel);
+	EndPhysicsMarker.AddPrerequisite(&InWorld, InWorld.EndPhysicsTickFunction);
+
+	UE_LOG(LogTemp, Log, TEXT("Soak: scenario %s, %.0f s warmup, %.0f s measured"), *Scenario->Name, ScenarioWarmup, ScenarioSeconds);
+}
+
+void UMySoakTestSubsystem::TickScenario(double NowSeconds)
+{
+	const double Elapsed = NowSeconds - ScenarioStartSeconds;
+	bScenarioMeasuring = Elapsed >= ScenarioWarmup;
+
+	if (Scenario->UltimateInterval > 0.f && NowSeconds >= NextUltimateSeconds)
+	{
+		for (TActorIterator<AMyCharacter> It(GetWorld()); It; ++It)
+		{
+			FMyBotInput Input;
+			Input.bAim = It->ReturnIsAiming(); //Only the ultimate changes
+			Input.bUltimate = true;
+			It->ApplyBotInput(Input, 0.f);
+		}
+		NextUltimateSeconds = NowSeconds + Scenario->UltimateInterval;
+	}
+
+	if (Elapsed >= ScenarioWarmup + ScenarioSeconds)
+	{
+		FinishScenario();
+	}
+}
+
+void UMySoakTestSubsystem::FinishScenario()
+{
+	bRunning = false;
+	bScenarioMeasuring = false;
+
+	auto Percentile95 = [](TArray<float>& Values)
+	{
+		if (Values.Num() == 0)
+		{
+			return 0.f;
+		}
+		Values.Sort();
+		return Values[FMath::Clamp(FMath::CeilToInt(0.95f * Values.Num()) - 1, 0, Values.Num() - 1)];
+	};
+	const int32 NumFrames = GameThreadMs.Num();
+	const float GameThreadP95 = Percentile95(GameThreadMs);
+	const float DuringPhysicsP95 = Percentile95(DuringPhysicsMs);
+	const bool bPassed = NumFrames > 0 && GameThreadP95 <= Scenario->GameThreadMs && DuringPhysicsP95 <= Scenario->DuringPhysicsMs;
+
+	const FString ResultsPath = FPaths::ProfilingDir() / TEXT("Soak") / TEXT("Scenarios.csv");
+	if (!IFileManager::Get().FileExists(*ResultsPath))
+	{
+		FFileHelper::SaveStringToFile(TEXT("Scenario,Date,Frames,GameThreadP95Ms,GameThreadBudgetMs,DuringPhysicsP95Ms,DuringPhysicsBudgetMs,Passed\n"), *ResultsPath);
+	}
+	const FString Row = FString::Printf(TEXT("%s,%s,%d,%.3f,%.3f,%.3f,%.3f,%d\n"), *Scenario->Name, *FDateTime::Now().ToString(), NumFrames,
+		GameThreadP95, Scenario->GameThreadMs, DuringPhysicsP95, Scenario->DuringPhysicsMs, bPassed ? 1 : 0);
+	FFileHelper::SaveStringToFile(Row, *ResultsPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+
+	UE_LOG(LogTemp, Log, TEXT("Soak: scenario %s %s over %d frames: game thread p95 %.2f ms (budget %.2f), during-physics p95 %.2f ms (budget %.2f)"),
+		*Scenario->Name, bPassed ? TEXT("passed") : TEXT("FAILED"), NumFrames, GameThreadP95, Scenario->GameThreadMs, DuringPhysicsP95, Scenario->DuringPhysicsMs);
+	FPlatformMisc::RequestExitWithStatus(false, bPassed ? 0 : 1);
+}
+
+void UMySoakTestSubsystem::OnWorldTickStart(UWorld* TickedWorld, ELevelTick TickType, float DeltaTime)
+{
+	if (TickedWorld == GetWorld())
+	{
+		WorldTickStartCycles = FPlatformTime::Cycles64();
+	}
+}
+
+void UMySoakTestSubsystem::OnWorldPostActorTick(UWorld* TickedWorld, ELevelTick TickType, float DeltaTime)
+{
+	if (TickedWorld == GetWorld() && bScenarioMeasuring && WorldTickStartCycles != 0)
+	{
+		GameThreadMs.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - WorldTickStartCycles));
+	}
+}
+
+void FMySoakPhysicsTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (bStartOfPhysics)
+	{
+		Soak->PhysicsStartCycles = FPlatformTime::Cycles64();
+	}
+	else if (Soak->bScenarioMeasuring && Soak->PhysicsStartCycles != 0)
+	{
+		Soak->DuringPhysicsMs.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - Soak->PhysicsStartCycles));
+	}
+}
+
+FString FMySoakPhysicsTickFunction::DiagnosticMessage()
+{
+	return bStartOfPhysics ? TEXT("UMySoakTestSubsystem[StartPhysics]") : TEXT("UMySoakTestSubsystem[EndPhysics]");
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+#include "MyCombatStats.h"
+#include "MySoakTestSubsystem.generated.h"
+
+class AMyCharacter;
+class AMyWeapon;
+
+//Memory budget for one LLM tag, scaled by the soak population: Base + PerBot * bots + PerWeapon * loose weapons
+USTRUCT()
+struct FMySoakLLMBudget
+{
+	GENERATED_BODY()
+
+	FMySoakLLMBudget() {}
+	FMySoakLLMBudget(FName InTag, float InBaseMB, float InPerBotMB, float InPerWeaponMB)
+		: Tag(InTag), BaseMB(InBaseMB), PerBotMB(InPerBotMB), PerWeaponMB(InPerWeaponMB) {}
+
+	UPROPERTY(Config)
+	FName Tag; //LLM tag name, e.g. Shooter/Character
+	UPROPERTY(Config)
+	float BaseMB = 0.f;
+	UPROPERTY(Config)
+	float PerBotMB = 0.f;
+	UPROPERTY(Config)
+	float PerWeaponMB = 0.f;
+};
+
+//Frame time budget for one -SoakScenario, compared against the 95th percentile of the measured frames
+USTRUCT()
+struct FMySoakScenarioBudget
+{
+	GENERATED_BODY()
+
+	FMySoakScenarioBudget() {}
+	FMySoakScenarioBudget(const FString& InName, int32 InBots, int32 InWeapons, float InUltimateInterval, float InGameThreadMs, float InDuringPhysicsMs, float InWeaponExtent = 0.f)
+		: Name(InName), Bots(InBots), Weapons(InWeapons), WeaponExtent(InWeaponExtent), UltimateInterval(InUltimateInterval), GameThreadMs(InGameThreadMs), DuringPhysicsMs(InDuringPhysicsMs) {}
+
+	UPROPERTY(Config)
+	FString Name;
+	UPROPERTY(Config)
+	int32 Bots = 0;
+	UPROPERTY(Config)
+	int32 Weapons = 0;
+	UPROPERTY(Config)
+	float WeaponExtent = 0.f; //Weapons are spread over +-this around the center, 0 grows the field with the weapon count
+	UPROPERTY(Config)
+	float UltimateInterval = 0.f; //Every bot fires its ultimate at once this often, 0 leaves it to the bots
+	UPROPERTY(Config)
+	float GameThreadMs = 0.f;
+	UPROPERTY(Config)
+	float DuringPhysicsMs = 0.f; //Game thread time from the start of physics until it has finished, TG_DuringPhysics ticks included
+};
+
+//Marks the start or the end of the during-physics window for scenario timing
+USTRUCT()
+struct FMySoakPhysicsTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	class UMySoakTestSubsystem* Soak = nullptr;
+	bool bStartOfPhysics = false;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FMySoakPhysicsTickFunction> : public TStructOpsTypeTraitsBase2<FMySoakPhysicsTickFunction>
+{
+	enum { WithCopy = false };
+};
+
+//Headless load test for the combat loop. Only created when the command line has -SoakBots=N or -SoakScenario=, normally together with -nullrhi:
+//  -SoakBots=N       AI driven AMyCharacter bots to spawn
+//  -SoakWeapons=N    loose weapons scattered around for the bots to pick up
+//  -SoakSeed=N       seed for bot decisions and spawn layout
+//  -SoakMinutes=N    quit after N samples, 0 runs until closed
+//  -SoakInterval=S   seconds per CSV row, default 60
+//  -SoakLLMBudgets   check the Shooter/* LLM tags against LLMBudgets every sample and quit with exit code 1 on the first
+//                    one over budget. Needs -llm, so the tags are tracked at all.
+//  -SoakScenario=Name  run one of Scenarios instead (bot/weapon counts come from it), warm up, then time the game thread and
+//                    the during-physics window (StartPhysics to EndPhysics, TG_DuringPhysics ticks included) per frame for
+//                    -SoakScenarioSeconds (default 60). Exits with code 1 if the p95 of either is over the scenario's budget,
+//                    or right away if the bot or pickup weapon class it needs isn't set or doesn't load.
+//                    Results go to Saved/Profiling/Soak/Scenarios.csv.
+//Every interval a row with frame time, trace/shot/emitter/spawn counts, decal pool usage and memory is appended to Saved/Profiling/Soak/.
+UCLASS(config = Game)
+class UE5POINT5_SHOOTER_API UMySoakTestSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UMySoakTestSubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+private:
+	bool SpawnBots(const FVector& Center);
+	bool SpawnWeapons(const FVector& Center);
+	void WriteSample();
+	bool CheckLLMBudgets() const;
+	void OnActorSpawned(AActor* Actor);
+	void OnWorldTickStart(UWorld* TickedWorld, ELevelTick TickType, float DeltaTime);
+	void OnWorldPostActorTick(UWorld* TickedWorld, ELevelTick TickType, float DeltaTime);
+	void StartScenario(UWorld& InWorld);
+	void TickScenario(double NowSeconds);
+	void FinishScenario();
+
+	friend struct FMySoakPhysicsTickFunction;
+
+	//Blueprint classes with meshes, FX and montages set up. Overridden by -SoakBotClass= and -SoakWeaponClass=
+	UPROPERTY(Config)
+	TSoftClassPtr<AMyCharacter> BotCharacterClass;
+	UPROPERTY(Config)
+	TSoftClassPtr<AMyWeapon> PickupWeaponClass;
+	UPROPERTY(Config)
+	TArray<FMySoakLLMBudget> LLMBudgets;
+	UPROPERTY(Config)
+	TArray<FMySoakScenarioBudget> Scenarios;
+
+	int32 NumBots;
+	int32 NumWeapons;
+	int32 Seed;
+	int32 DurationSamples;
+	float SampleInterval;
+	FString CsvPath;
+	bool bRunning;
+	bool bCheckLLMBudgets;
+
+	double LastFrameSeconds;
+	double SampleStartSeconds;
+	int32 SampleFrames;
+	double SampleFrameSecondsTotal;
+	double SampleFrameSecondsMax;
+	int64 SampleActorsSpawned;
+	int32 SampleIndex;
+	FMyCombatCounters LastCounters;
+	FDelegateHandle ActorSpawnedHandle;
+
+	//Scenario mode, Scenario is null otherwise
+	const FMySoakScenarioBudget* Scenario;
+	float ScenarioWarmup;
+	float ScenarioSeconds;
+	double ScenarioStartSeconds;
+	double NextUltimateSeconds;
+	bool bScenarioMeasuring;
+	uint64 WorldTickStartCycles;
+	uint64 PhysicsStartCycles;
+	TArray<float> GameThreadMs; //One entry per measured frame
+	TArray<float> DuringPhysicsMs;
+	FMySoakPhysicsTickFunction StartPhysicsMarker;
+	FMySoakPhysicsTickFunction EndPhysicsMarker;
+	FDelegateHandle WorldTickStartHandle;
+	FDelegateHandle WorldPostActorTickHandle;
+};
@@ -0,0 +1,70 @@
+#include "MySocketHandleCache.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMeshSocket.h"
+
+void FMySocketHandleCache::Reset()
+{
+	CachedMesh = nullptr;
+	CachedAsset = nullptr;
+	Handles.Reset();
+}
+
+FMySocketHandleCache::FSocketHandle* FMySocketHandleCache::FindOrResolve(const USkeletalMeshComponent* Mesh, FName SocketName)
+{
+	if (CachedMesh.Get() != Mesh || CachedAsset.Get() != Mesh->GetSkinnedAsset())
+	{
+		Reset();
+		CachedMesh = Mesh;
+		CachedAsset = Mesh->GetSkinnedAsset();
+	}
+
+	for (FSocketHandle& Handle : Handles)
+	{
+		if (Handle.SocketName == SocketName)
+		{
+			return Handle.BoneIndex != INDEX_NONE ? &Handle : nullptr;
+		}
+	}
+
+	//Misses are cached too, so asking for a missing socket doesn't search every time
+	FSocketHandle& Handle = Handles.AddDefaulted_GetRef();
+	Handle.SocketName = SocketName;
+	if (const USkeletalMeshSocket* Socket = Mesh->GetSocketByName(SocketName))
+	{
+		Handle.BoneIndex = Mesh->GetBoneIndex(Socket->BoneName);
+		Handle.LocalTransform = Socket->GetSocketLocalTransform();
+	}
+	else
+	{
+		Handle.BoneIndex = Mesh->GetBoneIndex(SocketName); //Plain bone name
+		Handle.LocalTransform = FTransform::Identity;
+	}
+	return Handle.BoneIndex != INDEX_NONE ? &Handle : nullptr;
+}
+
+bool FMySocketHandleCache::GetSocketTransform(const USkeletalMeshComponent* Mesh, FName SocketName, FTransform& OutTransform)
+{
+	FSocketHandle* Handle = Mesh ? FindOrResolve(Mesh, SocketName) : nullptr;
+	if (!Handle)
+	{
+		return false;
+	}
+	if (Handle->WorldTransformFrame != GFrameCounter)
+	{
+		Handle->WorldTransform = Handle->LocalTransform * Mesh->GetBoneTransform(Handle->BoneIndex);
+		Handle->WorldTransformFrame = GFrameCounter;
+	}
+	OutTransform = Handle->WorldTransform;
+	return true;
+}
+
+bool FMySocketHandleCache::GetSocketLocation(const USkeletalMeshComponent* Mesh, FName SocketName, FVector& OutLocation)
+{
+	FTransform SocketTransform;
+	if (!GetSocketTransform(Mesh, SocketName, SocketTransform))
+	{
+		return false;
+	}
+	OutLocation = SocketTransform.GetLocation();
+	return true;
+}
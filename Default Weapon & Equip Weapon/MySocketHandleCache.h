@@ -0,0 +1,32 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class USkeletalMeshComponent;
+
+//Fast repeated access to a few sockets of one skeletal mesh (muzzles).
+//The socket name is resolved once to its bone index and offset from the bone; the world transform is then one bone transform
+//times the offset, computed on first request each frame and reused for the rest of it. Changing the mesh asset resolves again.
+struct FMySocketHandleCache
+{
+	//False when the mesh has no socket or bone with that name
+	bool GetSocketTransform(const USkeletalMeshComponent* Mesh, FName SocketName, FTransform& OutTransform);
+	bool GetSocketLocation(const USkeletalMeshComponent* Mesh, FName SocketName, FVector& OutLocation);
+	void Reset();
+
+private:
+	struct FSocketHandle
+	{
+		FName SocketName;
+		int32 BoneIndex = INDEX_NONE;
+		FTransform LocalTransform;
+		FTransform WorldTransform;
+		uint64 WorldTransformFrame = MAX_uint64;
+	};
+
+	FSocketHandle* FindOrResolve(const USkeletalMeshComponent* Mesh, FName SocketName);
+
+	TWeakObjectPtr<const USkeletalMeshComponent> CachedMesh;
+	TWeakObjectPtr<const UObject> CachedAsset;
+	TArray<FSocketHandle, TInlineAllocator<4>> Handles;
+};
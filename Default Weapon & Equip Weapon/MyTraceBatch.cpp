@@ -0,0 +1,63 @@
+#include "MyTraceBatch.h"
+#include "MyCombatStats.h"
+#include "Engine/World.h"
+#include "Async/ParallelFor.h"
+
+DECLARE_CYCLE_STAT(TEXT("Trace Batch"), STAT_ShooterTraceBatch, STATGROUP_ShooterCombat);
+
+namespace MyTraceBatch
+{
+	//Below this a batch isn't worth waking up worker threads for
+	static constexpr int32 MinTracesPerTask = 16;
+
+	static EParallelForFlags GetFlags(int32 NumTraces)
+	{
+		return NumTraces < MinTracesPerTask * 2 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None;
+	}
+
+	void LineTraces(const UWorld* World, TArrayView<const FVector> Starts, TArrayView<const FVector> Ends, TArrayView<FHitResult> OutHits,
+		ECollisionChannel Channel, const FCollisionQueryParams& Params, TArrayView<const AActor* const> IgnoredActors)
+	{
+		SHOOTER_COMBAT_SCOPE(STAT_ShooterTraceBatch);
+		check(Starts.Num() == Ends.Num() && Starts.Num() == OutHits.Num());
+		check(IgnoredActors.Num() == 0 || IgnoredActors.Num() == Starts.Num());
+
+		const int32 NumTraces = Starts.Num();
+		ParallelFor(TEXT("MyTraceBatch::LineTraces"), NumTraces, MinTracesPerTask, [&](int32 Index)
+		{
+			OutHits[Index] = FHitResult();
+			if (IgnoredActors.Num() > 0 && IgnoredActors[Index])
+			{
+				FCollisionQueryParams TraceParams = Params;
+				TraceParams.AddIgnoredActor(IgnoredActors[Index]);
+				World->LineTraceSingleByChannel(OutHits[Index], Starts[Index], Ends[Index], Channel, TraceParams);
+			}
+			else
+			{
+				World->LineTraceSingleByChannel(OutHits[Index], Starts[Index], Ends[Index], Channel, Params);
+			}
+		}, GetFlags(NumTraces));
+		MyCombatStats::AddTraces(NumTraces);
+	}
+
+	void SphereSweeps(const UWorld* World, TArrayView<const FVector> Starts, TArrayView<const FVector> Ends, TArrayView<const float> Radii, TArrayView<FHitResult> OutHits,
+		ECollisionChannel Channel, const FCollisionQueryParams& Params, TArrayView<const AActor* const> IgnoredActors)
+	{
+		SHOOTER_COMBAT_SCOPE(STAT_ShooterTraceBatch);
+		check(Starts.Num() == Ends.Num() && Starts.Num() == OutHits.Num() && Starts.Num() == Radii.Num());
+		check(IgnoredActors.Num() == 0 || IgnoredActors.Num() == Starts.Num());
+
+		const int32 NumTraces = Starts.Num();
+		ParallelFor(TEXT("MyTraceBatch::SphereSweeps"), NumTraces, MinTracesPerTask, [&](int32 Index)
+		{
+			OutHits[Index] = FHitResult();
+			FCollisionQueryParams TraceParams = Params;
+			if (IgnoredActors.Num() > 0 && IgnoredActors[Index])
+			{
+				TraceParams.AddIgnoredActor(IgnoredActors[Index]);
+			}
+			World->SweepSingleByChannel(OutHits[Index], Starts[Index], Ends[Index], FQuat::Identity, Channel, FCollisionShape::MakeSphere(Radii[Index]), TraceParams);
+		}, GetFlags(NumTraces));
+		MyCombatStats::AddTraces(NumTraces);
+	}
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "CollisionQueryParams.h"
+
+//Runs many independent scene queries in one batch, spread over worker threads.
+//Scene queries only read the physics scene, so they can run in parallel as long as nothing moves bodies meanwhile (call from the game thread).
+//OutHits must be as long as Starts/Ends. IgnoredActors is optional, one entry per trace, added on top of Params.
+namespace MyTraceBatch
+{
+	UE5POINT5_SHOOTER_API void LineTraces(const UWorld* World, TArrayView<const FVector> Starts, TArrayView<const FVector> Ends, TArrayView<FHitResult> OutHits,
+		ECollisionChannel Channel, const FCollisionQueryParams& Params, TArrayView<const AActor* const> IgnoredActors = {});
+
+	UE5POINT5_SHOOTER_API void SphereSweeps(const UWorld* World, TArrayView<const FVector> Starts, TArrayView<const FVector> Ends, TArrayView<const float> Radii, TArrayView<FHitResult> OutHits,
+		ECollisionChannel Channel, const FCollisionQueryParams& Params, TArrayView<const AActor* const> IgnoredActors = {});
+}
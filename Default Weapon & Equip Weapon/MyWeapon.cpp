@@ -1,2 +1,212 @@
 #include "MyWeapon.h"
+#include "Curves/CurveFloat.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "UObject/ObjectSaveContext.h"
+#include "MyCombatStats.h"
 
+static constexpr float FixedDegreesScale = 256.f;
+static constexpr float FixedRollScale = 65536.f / (2.f * PI);
+
+AMyWeapon::AMyWeapon(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	FireMode = EWeaponFireMode::EWFM_SingleShot;
+	bAutomatic = false;
+	RoundsPerMinute = 600.f;
+	PelletCount = 10;
+	PelletSpreadAngle = 6.f;
+	PelletPatternSeed = 1337;
+	PelletDamage = 8.f;
+
+	PenetrationBudget = 3.f;
+	DefaultPenetrationCost = 1.f;
+	PenetrationDamageFalloff = 0.3f;
+
+	MuzzleVelocity = 30'000.f;
+	BulletGravityScale = 1.f;
+	BulletLifetime = 3.f;
+
+	RecoilPitchCurve = nullptr;
+	RecoilYawCurve = nullptr;
+	SpreadCurve = nullptr;
+	PatternLength = 30;
+	SpreadPatternSeed = 4242;
+	PatternRecoveryTime = 0.15f;
+}
+
+void AMyWeapon::PostInitializeComponents()
+{
+	LLM_SCOPE_BYTAG(Shooter_Weapons);
+	Super::PostInitializeComponents();
+	BuildPelletPattern();
+	BuildPenetrationCosts();
+}
+
+void AMyWeapon::BuildPenetrationCosts()
+{
+	//Flat table so the per hit lookup doesn't hash
+	for (float& Cost : SurfacePenetrationCost)
+	{
+		Cost = DefaultPenetrationCost;
+	}
+	for (const TPair<TEnumAsByte<EPhysicalSurface>, float>& Entry : PenetrationCosts)
+	{
+		SurfacePenetrationCost[Entry.Key] = Entry.Value;
+	}
+}
+
+void AMyWeapon::BuildPelletPattern()
+{
+	if (FireMode != EWeaponFireMode::EWFM_PelletSpread)
+	{
+		PelletPattern.Reset();
+		return;
+	}
+
+	//Stratified disc: pellet i gets its own angle and radius band, jittered from the seed, so spread stays even but not regular
+	FRandomStream Stream(PelletPatternSeed);
+	const float SpreadTangent = FMath::Tan(FMath::DegreesToRadians(PelletSpreadAngle));
+	PelletPattern.SetNum(PelletCount);
+	for (int32 Pellet = 0; Pellet < PelletCount; Pellet++)
+	{
+		const float Angle = 2.f * PI * (Pellet + Stream.FRandRange(-0.35f, 0.35f)) / PelletCount;
+		const float Radius = SpreadTangent * FMath::Sqrt((Pellet + Stream.FRand()) / PelletCount);
+		PelletPattern[Pellet] = FVector2D(FMath::Cos(Angle), FMath::Sin(Angle)) * Radius;
+	}
+}
+
+void AMyWeapon::GetPelletDirections(const FVector& AimDirection, uint8 ShotSequence, TArray<FVector>& OutDirections) const
+{
+	OutDirections.Reset();
+
+	//Same roll for the same shot on every machine
+	FRandomStream RollStream(static_cast<int32>(PelletPatternSeed ^ (ShotSequence * 2654435761u)));
+	float RollSin, RollCos;
+	FMath::SinCos(&RollSin, &RollCos, RollStream.FRandRange(0.f, 2.f * PI));
+
+	const FMatrix AimBasis = FRotationMatrix::MakeFromX(AimDirection);
+	const FVector Right = AimBasis.GetUnitAxis(EAxis::Y);
+	const FVector Up = AimBasis.GetUnitAxis(EAxis::Z);
+	for (const FVector2D& Offset : PelletPattern)
+	{
+		const float RolledX = Offset.X * RollCos - Offset.Y * RollSin;
+		const float RolledY = Offset.X * RollSin + Offset.Y * RollCos;
+		OutDirections.Add((AimDirection + Right * RolledX + Up * RolledY).GetSafeNormal());
+	}
+}
+
+void AMyWeapon::BakePatternTables(FMyShotPatternTables& OutTables) const
+{
+	OutTables = FMyShotPatternTables();
+	if (!RecoilPitchCurve && !RecoilYawCurve && !SpreadCurve)
+	{
+		return;
+	}
+
+	auto ToFixedDegrees = [](const UCurveFloat* Curve, int32 Shot) -> int16
+	{
+		const float Degrees = Curve ? Curve->GetFloatValue(static_cast<float>(Shot)) : 0.f;
+		return static_cast<int16>(FMath::Clamp(FMath::RoundToInt(Degrees * FixedDegreesScale), MIN_int16, MAX_int16));
+	};
+
+	FRandomStream RollStream(SpreadPatternSeed);
+	for (int32 Shot = 0; Shot < PatternLength; Shot++)
+	{
+		OutTables.RecoilPitch.Add(ToFixedDegrees(RecoilPitchCurve, Shot));
+		OutTables.RecoilYaw.Add(ToFixedDegrees(RecoilYawCurve, Shot));
+		OutTables.Spread.Add(ToFixedDegrees(SpreadCurve, Shot));
+		OutTables.SpreadRoll.Add(static_cast<uint16>(RollStream.RandHelper(65536)));
+	}
+}
+
+bool AMyWeapon::IsPatternBakeCurrent() const
+{
+	FMyShotPatternTables Fresh;
+	BakePatternTables(Fresh);
+	return Fresh == ShotPattern;
+}
+
+void AMyWeapon::PreSave(FObjectPreSaveContext ObjectSaveContext)
+{
+	BakePatternTables(ShotPattern); //Also runs when cooking
+	Super::PreSave(ObjectSaveContext);
+}
+
+#if WITH_EDITOR
+void AMyWeapon::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	BakePatternTables(ShotPattern);
+}
+#endif
+
+int32 AMyWeapon::GetPatternIndex(int32 ShotCount, float TimeSinceLastShot) const
+{
+	const float RecoveryTime = FMath::Max(PatternRecoveryTime, KINDA_SMALL_NUMBER);
+	if (TimeSinceLastShot >= RecoveryTime * ShotCount)
+	{
+		return 0; //Fully recovered, also keeps the "never fired" gap (from the lowest float) out of the int conversion
+	}
+	const int32 Recovered = FMath::FloorToInt(TimeSinceLastShot / RecoveryTime);
+	return FMath::Clamp(ShotCount - Recovered, 0, FMath::Max(ShotPattern.Spread.Num() - 1, 0));
+}
+
+FRotator AMyWeapon::GetRecoil(int32 PatternIndex) const
+{
+	if (!ShotPattern.RecoilPitch.IsValidIndex(PatternIndex))
+	{
+		return FRotator::ZeroRotator;
+	}
+	return FRotator(ShotPattern.RecoilPitch[PatternIndex] / FixedDegreesScale, ShotPattern.RecoilYaw[PatternIndex] / FixedDegreesScale, 0.f);
+}
+
+FVector AMyWeapon::ApplySpread(const FVector& AimDirection, int32 PatternIndex) const
+{
+	if (!ShotPattern.Spread.IsValidIndex(PatternIndex) || ShotPattern.Spread[PatternIndex] == 0)
+	{
+		return AimDirection;
+	}
+	float RollSin, RollCos;
+	FMath::SinCos(&RollSin, &RollCos, ShotPattern.SpreadRoll[PatternIndex] / FixedRollScale);
+	const float Offset = FMath::Tan(FMath::DegreesToRadians(ShotPattern.Spread[PatternIndex] / FixedDegreesScale));
+
+	const FMatrix AimBasis = FRotationMatrix::MakeFromX(AimDirection);
+	return (AimDirection + AimBasis.GetUnitAxis(EAxis::Y) * (Offset * RollCos) + AimBasis.GetUnitAxis(EAxis::Z) * (Offset * RollSin)).GetSafeNormal();
+}
+
+//Shooter.Weapon.VerifyPatterns [Lookups]
+//For every weapon in the world: checks the cooked pattern tables still match a fresh bake from the curves, then times Lookups
+//index/recoil/spread lookups. Client/server agreement itself is covered by the Shooter.Weapon.ShotPatternClientServer automation test.
+static FAutoConsoleCommandWithWorldAndArgs GVerifyPatternsCommand(
+	TEXT("Shooter.Weapon.VerifyPatterns"),
+	TEXT("Shooter.Weapon.VerifyPatterns [Lookups]: check baked shot patterns against their curves and time the lookup"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World)
+		{
+			return;
+		}
+		const int32 Lookups = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1'000'000;
+		for (TActorIterator<AMyWeapon> It(World); It; ++It)
+		{
+			const AMyWeapon* Weapon = *It;
+			const bool bCurrent = Weapon->IsPatternBakeCurrent();
+
+			FVector Direction = FVector::ForwardVector;
+			FRotator Recoil = FRotator::ZeroRotator;
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			for (int32 Lookup = 0; Lookup < Lookups; Lookup++)
+			{
+				const int32 PatternIndex = Weapon->GetPatternIndex(Lookup & 63, (Lookup & 7) * 0.05f);
+				Recoil += Weapon->GetRecoil(PatternIndex);
+				Direction = Weapon->ApplySpread(Direction, PatternIndex);
+			}
+			const double Nanoseconds = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1'000'000.0 / FMath::Max(Lookups, 1);
+
+			UE_LOG(LogTemp, Log, TEXT("%s: %d pattern shots, bake %s, %.1f ns per lookup (%s)"),
+				*Weapon->GetName(), Weapon->GetShotPattern().Spread.Num(), bCurrent ? TEXT("matches curves") : TEXT("STALE, resave the weapon"),
+				Nanoseconds, *(Direction + Recoil.Vector()).ToString());
+		}
+	}));
@@ -4,9 +4,129 @@
 #include "MyItem.h"
 #include "MyWeapon.generated.h"
 
+UENUM(BlueprintType)
+enum class EWeaponFireMode :uint8
+{
+	EWFM_SingleShot UMETA(DisplayName = "Single Shot"),
+	EWFM_PelletSpread UMETA(DisplayName = "Pellet Spread"),
+	EWFM_Penetrating UMETA(DisplayName = "Penetrating"),
+	EWFM_Ballistic UMETA(DisplayName = "Ballistic")
+};
+
+//Recoil and spread per shot in a burst, baked from the designer curves so firing never evaluates a curve or a random stream.
+//Angles are fixed point: degrees in 1/256 steps, spread roll in 1/65536 turns. Client and server index the same cooked tables.
+USTRUCT()
+struct FMyShotPatternTables
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<int16> RecoilPitch;
+	UPROPERTY()
+	TArray<int16> RecoilYaw;
+	UPROPERTY()
+	TArray<int16> Spread;
+	UPROPERTY()
+	TArray<uint16> SpreadRoll;
+
+	bool operator==(const FMyShotPatternTables& Other) const
+	{
+		return RecoilPitch == Other.RecoilPitch && RecoilYaw == Other.RecoilYaw && Spread == Other.Spread && SpreadRoll == Other.SpreadRoll;
+	}
+};
+
 UCLASS()
 class UE5POINT5_SHOOTER_API AMyWeapon : public AMyItem
 {
 	GENERATED_BODY()
 
+public:
+	AMyWeapon(const FObjectInitializer& ObjectInitializer);
+	FORCEINLINE EWeaponFireMode GetFireMode() const { return FireMode; }
+	FORCEINLINE int32 GetPelletCount() const { return PelletPattern.Num(); }
+	FORCEINLINE float GetPelletDamage() const { return PelletDamage; }
+	//Pellet directions for one shot. The pattern is fixed per weapon and rotated per shot from ShotSequence, so client and server agree.
+	void GetPelletDirections(const FVector& AimDirection, uint8 ShotSequence, TArray<FVector>& OutDirections) const;
+	FORCEINLINE float GetPenetrationBudget() const { return PenetrationBudget; }
+	FORCEINLINE float GetPenetrationDamageScale() const { return 1.f - PenetrationDamageFalloff; }
+	FORCEINLINE float GetPenetrationCost(EPhysicalSurface Surface) const { return SurfacePenetrationCost[Surface]; }
+	FORCEINLINE bool IsAutomatic() const { return bAutomatic; }
+	FORCEINLINE float GetShotInterval() const { return 60.f / FMath::Max(RoundsPerMinute, 1.f); }
+	FORCEINLINE float GetMuzzleVelocity() const { return MuzzleVelocity; }
+	FORCEINLINE float GetBulletGravityScale() const { return BulletGravityScale; }
+	FORCEINLINE float GetBulletLifetime() const { return BulletLifetime; }
+
+	//Shot pattern. ShotCount is shots in the current burst, it winds back one step per PatternRecoveryTime without firing.
+	int32 GetPatternIndex(int32 ShotCount, float TimeSinceLastShot) const;
+	FRotator GetRecoil(int32 PatternIndex) const;
+	FVector ApplySpread(const FVector& AimDirection, int32 PatternIndex) const;
+	void BakePatternTables(FMyShotPatternTables& OutTables) const;
+	bool IsPatternBakeCurrent() const;
+	FORCEINLINE const FMyShotPatternTables& GetShotPattern() const { return ShotPattern; }
+
+	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+protected:
+	virtual void PostInitializeComponents() override;
+
+private:
+	friend class FMyWeaponShotPatternTest; //Sets up curves and fire mode without a Blueprint
+
+	void BuildPelletPattern();
+	void BuildPenetrationCosts();
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Weapon, meta = (AllowPrivateAccess = "true"))
+	EWeaponFireMode FireMode;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Weapon, meta = (AllowPrivateAccess = "true"))
+	bool bAutomatic; //Keeps firing while the button is held
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Weapon, meta = (AllowPrivateAccess = "true", EditCondition = "bAutomatic"))
+	float RoundsPerMinute;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Weapon, meta = (AllowPrivateAccess = "true", ClampMin = "1", ClampMax = "32"))
+	int32 PelletCount;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Weapon, meta = (AllowPrivateAccess = "true"))
+	float PelletSpreadAngle; //Degrees from the aim direction to the outer ring
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Weapon, meta = (AllowPrivateAccess = "true"))
+	int32 PelletPatternSeed;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Weapon, meta = (AllowPrivateAccess = "true"))
+	float PelletDamage;
+
+	TArray<FVector2D> PelletPattern; //Tangent space offsets (yaw, pitch), built once from the seed
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Penetration, meta = (AllowPrivateAccess = "true"))
+	float PenetrationBudget; //Spent by every surface the shot passes through, the shot stops in the surface that overdraws it
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Penetration, meta = (AllowPrivateAccess = "true"))
+	float DefaultPenetrationCost; //Cost of surfaces not listed in PenetrationCosts
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Penetration, meta = (AllowPrivateAccess = "true"))
+	TMap<TEnumAsByte<EPhysicalSurface>, float> PenetrationCosts;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Penetration, meta = (AllowPrivateAccess = "true", ClampMin = "0", ClampMax = "1"))
+	float PenetrationDamageFalloff; //Fraction of damage lost per surface passed through
+
+	float SurfacePenetrationCost[SurfaceType_Max]; //PenetrationCosts flattened, indexed by surface type
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ballistics, meta = (AllowPrivateAccess = "true"))
+	float MuzzleVelocity; //cm/s
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ballistics, meta = (AllowPrivateAccess = "true"))
+	float BulletGravityScale;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ballistics, meta = (AllowPrivateAccess = "true"))
+	float BulletLifetime; //Seconds before a bullet that hit nothing is dropped
+
+	//Designer curves, X is the shot number in a burst. Only read when baking.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Pattern, meta = (AllowPrivateAccess = "true"))
+	class UCurveFloat* RecoilPitchCurve; //Degrees of camera kick up
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Pattern, meta = (AllowPrivateAccess = "true"))
+	class UCurveFloat* RecoilYawCurve; //Degrees of camera kick right
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Pattern, meta = (AllowPrivateAccess = "true"))
+	class UCurveFloat* SpreadCurve; //Degrees off the aim direction
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Pattern, meta = (AllowPrivateAccess = "true", ClampMin = "1", ClampMax = "255"))
+	int32 PatternLength; //Shots baked, later shots in a burst repeat the last entry
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Pattern, meta = (AllowPrivateAccess = "true"))
+	int32 SpreadPatternSeed;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Pattern, meta = (AllowPrivateAccess = "true"))
+	float PatternRecoveryTime;
+
+	UPROPERTY()
+	FMyShotPatternTables ShotPattern; //Baked on save and on edit, cooked with the weapon
 };
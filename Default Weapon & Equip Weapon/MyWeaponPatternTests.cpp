@@ -0,0 +1,139 @@
+#include "MyWeapon.h"
+#include "MyFireTypes.h"
+#include "Curves/CurveFloat.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/ScopeExit.h"
+#include "UObject/CoreNet.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+//Fires a long burst sequence on the client side of a weapon, sends every shot through FMyFireShot's net serializer and checks
+//the server side gets the same pattern index, spread direction and pellet fan from what it received. The sequence starts
+//close to 255 so ShotSequence wraps during the run.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMyWeaponShotPatternTest, "Shooter.Weapon.ShotPatternClientServer",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+namespace MyWeaponPatternTests
+{
+	UCurveFloat* MakeCurve(UObject* Outer, float Start, float End)
+	{
+		UCurveFloat* Curve = NewObject<UCurveFloat>(Outer);
+		Curve->FloatCurve.AddKey(0.f, Start);
+		Curve->FloatCurve.AddKey(20.f, End);
+		return Curve;
+	}
+
+	//What each side keeps to walk the pattern: shots into the burst and when the last one went out
+	struct FPatternTracker
+	{
+		int32 ShotCount = 0;
+		float LastShotTime = -1000.f;
+
+		uint8 Advance(const AMyWeapon& Weapon, float ShotTime)
+		{
+			const int32 PatternIndex = Weapon.GetPatternIndex(ShotCount, ShotTime - LastShotTime);
+			ShotCount = PatternIndex + 1;
+			LastShotTime = ShotTime;
+			return static_cast<uint8>(PatternIndex);
+		}
+	};
+}
+
+bool FMyWeaponShotPatternTest::RunTest(const FString& Parameters)
+{
+	using namespace MyWeaponPatternTests;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	ON_SCOPE_EXIT
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	};
+
+	AMyWeapon* Weapon = World->SpawnActorDeferred<AMyWeapon>(AMyWeapon::StaticClass(), FTransform::Identity);
+	Weapon->FireMode = EWeaponFireMode::EWFM_PelletSpread;
+	Weapon->PelletCount = 9;
+	Weapon->RecoilPitchCurve = MakeCurve(Weapon, 0.5f, 2.f);
+	Weapon->RecoilYawCurve = MakeCurve(Weapon, -0.2f, 0.6f);
+	Weapon->SpreadCurve = MakeCurve(Weapon, 0.1f, 4.f);
+	Weapon->FinishSpawning(FTransform::Identity); //Builds the pellet pattern
+	Weapon->BakePatternTables(Weapon->ShotPattern);
+	TestTrue(TEXT("Pattern bake matches the curves"), Weapon->IsPatternBakeCurrent());
+	TestTrue(TEXT("Weapon has a spread pattern"), Weapon->GetShotPattern().Spread.Num() > 1);
+
+	//Shot times are multiples of 1/64 s so both sides see exactly the same float timestamps
+	static constexpr int32 NumShots = 400;
+	static constexpr uint8 FirstSequence = 240;
+	FRandomStream Random(7);
+	FPatternTracker ClientPattern;
+	FPatternTracker ServerPattern;
+	uint8 LastServerSequence = FirstSequence - 1;
+	float ShotTime = 1000.f;
+	FVector AimDirection = FVector::ForwardVector;
+	TArray<FVector> ClientPellets;
+	TArray<FVector> ServerPellets;
+	bool bWrapped = false;
+
+	for (int32 ShotIndex = 0; ShotIndex < NumShots; ShotIndex++)
+	{
+		ShotTime += (Random.FRand() < 0.15f ? Random.RandRange(16, 48) : Random.RandRange(4, 8)) / 64.f; //Bursts with pauses between
+		AimDirection = FRotator(Random.FRandRange(-10.f, 10.f), Random.FRandRange(-180.f, 180.f), 0.f).Vector();
+
+		//Client
+		FMyFireShot Shot;
+		Shot.MuzzleLocation = FVector(100.f, 50.f, 60.f);
+		Shot.ShotDirection = AimDirection;
+		Shot.ClientTimeStamp = ShotTime;
+		Shot.ShotSequence = static_cast<uint8>(FirstSequence + ShotIndex);
+		Shot.PatternIndex = ClientPattern.Advance(*Weapon, ShotTime);
+		const FVector ClientSpread = Weapon->ApplySpread(AimDirection, Shot.PatternIndex);
+		Weapon->GetPelletDirections(ClientSpread, Shot.ShotSequence, ClientPellets);
+		bWrapped |= Shot.ShotSequence < FirstSequence;
+
+		//Wire
+		FNetBitWriter Writer(nullptr, 256);
+		bool bSuccess = true;
+		Shot.NetSerialize(Writer, nullptr, bSuccess);
+		FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+		FMyFireShot Received;
+		Received.NetSerialize(Reader, nullptr, bSuccess);
+		if (!TestTrue(TEXT("Shot serializes"), bSuccess && !Reader.IsError()))
+		{
+			return false;
+		}
+
+		//Server
+		const FString Context = FString::Printf(TEXT("shot %d (sequence %d, pattern %d)"), ShotIndex, Received.ShotSequence, Received.PatternIndex);
+		TestTrue(FString::Printf(TEXT("Sequence accepted, %s"), *Context), IsNewerShotSequence(Received.ShotSequence, LastServerSequence));
+		TestFalse(FString::Printf(TEXT("Duplicate rejected, %s"), *Context), IsNewerShotSequence(LastServerSequence, Received.ShotSequence));
+		LastServerSequence = Received.ShotSequence;
+
+		//The server works the index out itself and only accepts a shot that claims the same one
+		const uint8 ServerPatternIndex = ServerPattern.Advance(*Weapon, Received.ClientTimeStamp);
+		TestEqual(FString::Printf(TEXT("Server pattern index, %s"), *Context), static_cast<int32>(ServerPatternIndex), static_cast<int32>(Received.PatternIndex));
+
+		static constexpr float DirectionTolerance = 1e-3f; //16 bit per axis direction quantization
+		const FVector ServerSpread = Weapon->ApplySpread(Received.ShotDirection, ServerPatternIndex);
+		TestTrue(FString::Printf(TEXT("Spread direction, %s"), *Context), ServerSpread.Equals(ClientSpread, DirectionTolerance));
+		Weapon->GetPelletDirections(ServerSpread, Received.ShotSequence, ServerPellets);
+		if (TestEqual(FString::Printf(TEXT("Pellet count, %s"), *Context), ServerPellets.Num(), ClientPellets.Num()))
+		{
+			for (int32 Pellet = 0; Pellet < ServerPellets.Num(); Pellet++)
+			{
+				TestTrue(FString::Printf(TEXT("Pellet %d direction, %s"), Pellet, *Context), ServerPellets[Pellet].Equals(ClientPellets[Pellet], DirectionTolerance));
+			}
+		}
+	}
+	TestTrue(TEXT("Shot sequence wrapped during the run"), bWrapped);
+
+	//Reordered and replayed shots across the wrap stay rejected
+	TestFalse(TEXT("Older shot before the wrap rejected"), IsNewerShotSequence(250, 3));
+	TestTrue(TEXT("Newer shot after the wrap accepted"), IsNewerShotSequence(3, 250));
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
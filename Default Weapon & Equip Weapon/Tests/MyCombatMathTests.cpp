@@ -0,0 +1,145 @@
+#include "MyCombatMath.h"
+#include <gtest/gtest.h>
+
+//Reference values are what FMath::FInterpTo/VInterpTo/RInterpTo and FRotator::NormalizeAxis return for the same inputs
+namespace
+{
+	struct FTestVector
+	{
+		float X = 0.f;
+		float Y = 0.f;
+		float Z = 0.f;
+	};
+
+	struct FTestRotator
+	{
+		float Pitch = 0.f;
+		float Yaw = 0.f;
+		float Roll = 0.f;
+	};
+
+	void ExpectVector(const FTestVector& Actual, float X, float Y, float Z)
+	{
+		EXPECT_FLOAT_EQ(Actual.X, X);
+		EXPECT_FLOAT_EQ(Actual.Y, Y);
+		EXPECT_FLOAT_EQ(Actual.Z, Z);
+	}
+
+	void ExpectRotator(const FTestRotator& Actual, float Pitch, float Yaw, float Roll)
+	{
+		EXPECT_NEAR(Actual.Pitch, Pitch, 1e-4f);
+		EXPECT_NEAR(Actual.Yaw, Yaw, 1e-4f);
+		EXPECT_NEAR(Actual.Roll, Roll, 1e-4f);
+	}
+}
+
+TEST(MyCombatMathNormalizeAxis, WrapsIntoHalfOpenRange)
+{
+	EXPECT_FLOAT_EQ(MyCombatMath::NormalizeAxis(0.f), 0.f);
+	EXPECT_FLOAT_EQ(MyCombatMath::NormalizeAxis(90.f), 90.f);
+	EXPECT_FLOAT_EQ(MyCombatMath::NormalizeAxis(-90.f), -90.f);
+	EXPECT_FLOAT_EQ(MyCombatMath::NormalizeAxis(190.f), -170.f);
+	EXPECT_FLOAT_EQ(MyCombatMath::NormalizeAxis(-190.f), 170.f);
+	EXPECT_FLOAT_EQ(MyCombatMath::NormalizeAxis(359.5f), -0.5f);
+	EXPECT_FLOAT_EQ(MyCombatMath::NormalizeAxis(720.f), 0.f);
+	EXPECT_FLOAT_EQ(MyCombatMath::NormalizeAxis(-360.f), 0.f);
+}
+
+TEST(MyCombatMathNormalizeAxis, PlusAndMinus180BothMapTo180)
+{
+	EXPECT_FLOAT_EQ(MyCombatMath::NormalizeAxis(180.f), 180.f);
+	EXPECT_FLOAT_EQ(MyCombatMath::NormalizeAxis(-180.f), 180.f);
+	EXPECT_FLOAT_EQ(MyCombatMath::NormalizeAxis(540.f), 180.f);
+	EXPECT_DOUBLE_EQ(MyCombatMath::NormalizeAxis(-540.0), 180.0);
+}
+
+TEST(MyCombatMathInterpTo, MovesByDeltaTimeTimesSpeed)
+{
+	EXPECT_FLOAT_EQ(MyCombatMath::InterpTo(0.f, 10.f, 0.1f, 5.f), 5.f);
+	EXPECT_FLOAT_EQ(MyCombatMath::InterpTo(90.f, 75.f, 0.05f, 4.f), 87.f);
+	EXPECT_FLOAT_EQ(MyCombatMath::InterpTo(0.f, 10.f, 1.f, 5.f), 10.f); //Alpha clamps to 1
+}
+
+TEST(MyCombatMathInterpTo, NonPositiveDeltaTimeStaysPut)
+{
+	EXPECT_FLOAT_EQ(MyCombatMath::InterpTo(3.f, 10.f, 0.f, 5.f), 3.f);
+	EXPECT_FLOAT_EQ(MyCombatMath::InterpTo(3.f, 10.f, -0.5f, 5.f), 3.f);
+}
+
+TEST(MyCombatMathInterpTo, NonPositiveSpeedSnapsToTarget)
+{
+	EXPECT_FLOAT_EQ(MyCombatMath::InterpTo(3.f, 10.f, 0.1f, 0.f), 10.f);
+	EXPECT_FLOAT_EQ(MyCombatMath::InterpTo(3.f, 10.f, 0.1f, -1.f), 10.f);
+}
+
+TEST(MyCombatMathInterpTo, CloseEnoughSnapsToTarget)
+{
+	EXPECT_FLOAT_EQ(MyCombatMath::InterpTo(1.f, 1.00001f, 0.01f, 1.f), 1.00001f);
+}
+
+TEST(MyCombatMathVectorInterpTo, MovesEveryAxisByTheSameAlpha)
+{
+	ExpectVector(MyCombatMath::VectorInterpTo(FTestVector{ 0.f, 0.f, 0.f }, FTestVector{ 10.f, 20.f, -30.f }, 0.1f, 2.f), 2.f, 4.f, -6.f);
+	ExpectVector(MyCombatMath::VectorInterpTo(FTestVector{ 0.f, 0.f, 0.f }, FTestVector{ 180.f, 0.f, 40.f }, 0.5f, 4.f), 180.f, 0.f, 40.f);
+}
+
+TEST(MyCombatMathVectorInterpTo, EdgeCases)
+{
+	const FTestVector Current{ 1.f, 2.f, 3.f };
+	const FTestVector Target{ 4.f, 5.f, 6.f };
+	ExpectVector(MyCombatMath::VectorInterpTo(Current, Target, 0.f, 5.f), 1.f, 2.f, 3.f);
+	ExpectVector(MyCombatMath::VectorInterpTo(Current, Target, -0.1f, 5.f), 1.f, 2.f, 3.f);
+	ExpectVector(MyCombatMath::VectorInterpTo(Current, Target, 0.1f, 0.f), 4.f, 5.f, 6.f);
+	ExpectVector(MyCombatMath::VectorInterpTo(Current, Target, 0.1f, -2.f), 4.f, 5.f, 6.f);
+	ExpectVector(MyCombatMath::VectorInterpTo(Current, FTestVector{ 1.001f, 2.f, 3.f }, 0.01f, 1.f), 1.001f, 2.f, 3.f);
+}
+
+TEST(MyCombatMathRotatorInterpTo, MovesEveryAxisByTheSameAlpha)
+{
+	ExpectRotator(MyCombatMath::RotatorInterpTo(FTestRotator{ 0.f, 0.f, 0.f }, FTestRotator{ 10.f, -20.f, 40.f }, 0.1f, 5.f), 5.f, -10.f, 20.f);
+}
+
+TEST(MyCombatMathRotatorInterpTo, TakesTheShortWayAcross180)
+{
+	ExpectRotator(MyCombatMath::RotatorInterpTo(FTestRotator{ 0.f, 170.f, 0.f }, FTestRotator{ 0.f, -170.f, 0.f }, 0.1f, 5.f), 0.f, 180.f, 0.f);
+	ExpectRotator(MyCombatMath::RotatorInterpTo(FTestRotator{ 0.f, -170.f, 0.f }, FTestRotator{ 0.f, 170.f, 0.f }, 0.1f, 5.f), 0.f, 180.f, 0.f);
+	ExpectRotator(MyCombatMath::RotatorInterpTo(FTestRotator{ 0.f, 179.f, 0.f }, FTestRotator{ 0.f, -179.f, 0.f }, 0.1f, 10.f), 0.f, -179.f, 0.f);
+	ExpectRotator(MyCombatMath::RotatorInterpTo(FTestRotator{ 0.f, 350.f, 0.f }, FTestRotator{ 0.f, 10.f, 0.f }, 0.1f, 5.f), 0.f, 0.f, 0.f);
+}
+
+TEST(MyCombatMathRotatorInterpTo, EdgeCases)
+{
+	const FTestRotator Current{ 10.f, 200.f, 0.f }; //Not normalized on purpose, zero DeltaTime hands it back untouched
+	const FTestRotator Target{ 20.f, 30.f, 0.f };
+	ExpectRotator(MyCombatMath::RotatorInterpTo(Current, Target, 0.f, 5.f), 10.f, 200.f, 0.f);
+	ExpectRotator(MyCombatMath::RotatorInterpTo(Current, Target, -0.1f, 5.f), 10.f, -160.f, 0.f); //Alpha clamps to 0, result is normalized
+	ExpectRotator(MyCombatMath::RotatorInterpTo(Current, Target, 0.1f, 0.f), 20.f, 30.f, 0.f);
+	ExpectRotator(MyCombatMath::RotatorInterpTo(Current, Target, 0.1f, -3.f), 20.f, 30.f, 0.f);
+	ExpectRotator(MyCombatMath::RotatorInterpTo(Target, Target, 0.1f, 5.f), 20.f, 30.f, 0.f);
+}
+
+TEST(MyCombatMathStrafeYaw, RelativeToAim)
+{
+	EXPECT_NEAR(MyCombatMath::StrafeYaw(1.f, 0.f, 0.f), 0.f, 1e-4f);
+	EXPECT_NEAR(MyCombatMath::StrafeYaw(0.f, 1.f, 0.f), 90.f, 1e-4f);
+	EXPECT_NEAR(MyCombatMath::StrafeYaw(0.f, -1.f, 0.f), -90.f, 1e-4f);
+	EXPECT_NEAR(MyCombatMath::StrafeYaw(0.f, 300.f, 90.f), 0.f, 1e-4f);
+	EXPECT_NEAR(MyCombatMath::StrafeYaw(0.f, 0.f, 30.f), -30.f, 1e-4f); //Standing still reads as moving along X
+}
+
+TEST(MyCombatMathStrafeYaw, WrapsAround180)
+{
+	EXPECT_NEAR(MyCombatMath::StrafeYaw(-1.f, 0.f, 0.f), 180.f, 1e-4f);
+	EXPECT_NEAR(MyCombatMath::StrafeYaw(1.f, 0.f, -170.f), 170.f, 1e-4f);
+	EXPECT_NEAR(MyCombatMath::StrafeYaw(1.f, 0.f, 170.f), -170.f, 1e-4f);
+	EXPECT_NEAR(MyCombatMath::StrafeYaw(-1.f, 0.f, -10.f), -170.f, 1e-4f);
+	EXPECT_NEAR(MyCombatMath::StrafeYaw(0.f, 1.f, -90.f), 180.f, 1e-4f);
+}
+
+TEST(MyCombatMathShotTraceEnd, DefaultAndCustomRange)
+{
+	ExpectVector(MyCombatMath::ShotTraceEnd(FTestVector{ 1.f, 2.f, 3.f }, FTestVector{ 0.f, 0.f, 1.f }), 1.f, 2.f, 50'003.f);
+	ExpectVector(MyCombatMath::ShotTraceEnd(FTestVector{ 0.f, 0.f, 0.f }, FTestVector{ 0.6f, 0.8f, 0.f }), 30'000.f, 40'000.f, 0.f);
+	ExpectVector(MyCombatMath::ShotTraceEnd(FTestVector{ 10.f, 0.f, 0.f }, FTestVector{ -1.f, 0.f, 0.f }, 100.f), -90.f, 0.f, 0.f);
+	ExpectVector(MyCombatMath::ShotTraceEnd(FTestVector{ 5.f, 5.f, 5.f }, FTestVector{ 1.f, 0.f, 0.f }, 0.f), 5.f, 5.f, 5.f);
+}